@@ -0,0 +1,95 @@
+//
+//  Benchmark.Invoke.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include "Benchmark.hpp"
+
+#include <Dream/Events/Thread.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Performs count round trips (ping-pong) from the loop of one thread to the loop of another using the given function, which must call done(loop) on the originating loop, and reports the latency distribution.
+		template <typename RoundTripT>
+		static void measure_round_trips (const char * name, std::size_t count, RoundTripT round_trip)
+		{
+			Ref<Thread> local = new Thread, remote = new Thread;
+			local->start();
+			remote->start();
+
+			std::unique_ptr<Histogram> latency(new Histogram);
+
+			std::atomic<bool> finished(false);
+			std::uint64_t start = 0;
+			std::size_t completed = 0;
+
+			std::function<void (Loop *)> next;
+			std::function<void (Loop *)> done = [&](Loop * loop) {
+				latency->record(Benchmark::timestamp() - start);
+
+				if (++completed < count)
+					next(loop);
+				else
+					finished = true;
+			};
+
+			next = [&](Loop * loop) {
+				start = Benchmark::timestamp();
+				round_trip(remote->loop(), done);
+			};
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+
+			local->loop()->post_urgent(next);
+
+			while (!finished)
+				Core::sleep(0.01);
+
+			TimeT duration = stopwatch.time();
+
+			local->stop();
+			remote->stop();
+
+			Benchmark::report(name, count, duration, *latency);
+		}
+
+		UnitTest::Suite InvokeBenchmarkSuite {
+			"Dream::Events::Invoke",
+
+			{"round trip latency between two threads using invoke compared to a pair of notifications",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 100000;
+
+					measure_round_trips("invoke", COUNT, [](Ref<Loop> remote, std::function<void (Loop *)> & done) {
+						remote->invoke([](Loop *){
+							return 1;
+						}).then([&](Loop * loop, int){
+							done(loop);
+						});
+					});
+
+					measure_round_trips("post_notification", COUNT, [](Ref<Loop> remote, std::function<void (Loop *)> & done) {
+						Ref<Loop> loop = Loop::current();
+
+						remote->post_notification(new NotificationSource([&, loop](Loop *, NotificationSource *, Event){
+							loop->post_notification(new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+								done(loop);
+							}), true);
+						}), true);
+					});
+				}
+			},
+		};
+	}
+}
@@ -0,0 +1,183 @@
+//
+//  Benchmark.Monitor.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include "Benchmark.hpp"
+
+#include <Dream/Events/Loop.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		class CountingSource : public Object, virtual public IFileDescriptorSource {
+		protected:
+			FileDescriptor _file_descriptor;
+			std::size_t & _count;
+
+		public:
+			CountingSource (FileDescriptor file_descriptor, std::size_t & count) : _file_descriptor(file_descriptor), _count(count)
+			{
+			}
+
+			virtual FileDescriptor file_descriptor () const
+			{
+				return _file_descriptor;
+			}
+
+			virtual void process_events (Loop *, Event event)
+			{
+				char buffer[16];
+
+				if (read(_file_descriptor, buffer, sizeof(buffer)) > 0)
+					_count += 1;
+			}
+		};
+
+		/// The number of socket pairs which can be opened, after raising the limit on open files as far as possible.
+		static std::size_t maximum_socket_pairs ()
+		{
+			struct rlimit limit;
+
+			if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+				return 0;
+
+			if (limit.rlim_cur < limit.rlim_max) {
+				limit.rlim_cur = limit.rlim_max;
+				setrlimit(RLIMIT_NOFILE, &limit);
+				getrlimit(RLIMIT_NOFILE, &limit);
+			}
+
+			// Leave some file descriptors for the loop itself:
+			return (limit.rlim_cur - 64) / 2;
+		}
+
+		/// Monitors count socket pairs, and then repeatedly makes a few of them readable and measures how long it takes the loop to dispatch them.
+		static void measure_dispatch (const char * name, MonitorType monitor_type, std::size_t count)
+		{
+			Ref<Loop> loop = new Loop(monitor_type);
+			loop->set_stop_when_idle(false);
+
+			std::size_t dispatched = 0;
+			std::vector<FileDescriptor> writers;
+			std::vector<Ref<CountingSource>> sources;
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				int pair[2];
+
+				if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+					break;
+
+				fcntl(pair[0], F_SETFL, O_NONBLOCK);
+
+				sources.push_back(new CountingSource(pair[0], dispatched));
+				writers.push_back(pair[1]);
+			}
+
+			// Fewer socket pairs may have been opened than requested:
+			if (sources.size() < count) {
+				std::cout << name << ": could only open " << sources.size() << " rather than " << count << " socket pairs" << std::endl;
+				count = sources.size();
+			}
+
+			if (count == 0)
+				return;
+
+			const std::size_t ACTIVE = std::min<std::size_t>(count, 64);
+			const std::size_t ROUNDS = std::max<std::size_t>(20, std::min<std::size_t>(1000, 10000000 / count));
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+
+			for (auto & source : sources)
+				loop->monitor(source, READ_READY);
+
+			TimeT register_duration = stopwatch.time();
+
+			std::unique_ptr<Histogram> latency(new Histogram);
+
+			stopwatch.start();
+
+			for (std::size_t round = 0; round < ROUNDS; round += 1) {
+				std::uint64_t started = Benchmark::timestamp();
+
+				// Spread the active sockets over all of them:
+				for (std::size_t i = 0; i < ACTIVE; i += 1)
+					write(writers[(round * 7919 + i * (count / ACTIVE)) % count], "x", 1);
+
+				std::size_t target = (round + 1) * ACTIVE;
+
+				while (dispatched < target)
+					loop->run_once(true);
+
+				latency->record(Benchmark::timestamp() - started);
+			}
+
+			TimeT dispatch_duration = stopwatch.time();
+
+			std::string prefix = std::string(name) + " with " + std::to_string(count) + " socket pairs";
+
+			Benchmark::report(prefix + ": monitor", count, register_duration);
+			Benchmark::report(prefix + ": dispatch (latency of " + std::to_string(ACTIVE) + " events)", dispatched, dispatch_duration, *latency);
+
+			for (std::size_t i = 0; i < sources.size(); i += 1) {
+				loop->stop_monitoring_file_descriptor(sources[i]);
+
+				close(sources[i]->file_descriptor());
+				close(writers[i]);
+			}
+		}
+
+		UnitTest::Suite MonitorBenchmarkSuite {
+			"Dream::Events::Monitor",
+
+			{"dispatching events from 1 to 100,000 file descriptors with each monitor",
+				[](UnitTest::Examiner & examiner) {
+					struct {
+						const char * name;
+						MonitorType type;
+					} monitors[] = {
+						{"poll", POLL_MONITOR},
+#if defined(TARGET_OS_LINUX)
+						{"epoll", EPOLL_MONITOR},
+						// Falls back to epoll if the kernel doesn't support io_uring:
+						{"io_uring", IO_URING_MONITOR},
+#else
+						{"kqueue", KQUEUE_MONITOR},
+#endif
+					};
+
+					std::size_t maximum = maximum_socket_pairs();
+
+					for (std::size_t count : {1, 100, 10000, 100000}) {
+						if (count > maximum) {
+							std::cout << "Using " << maximum << " rather than " << count << " socket pairs due to the limit on open files" << std::endl;
+							count = maximum;
+						}
+
+						for (auto & monitor : monitors)
+							measure_dispatch(monitor.name, monitor.type, count);
+
+						if (count == maximum)
+							break;
+					}
+				}
+			},
+		};
+	}
+}
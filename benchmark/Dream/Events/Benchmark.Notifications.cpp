@@ -0,0 +1,79 @@
+//
+//  Benchmark.Notifications.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include "Benchmark.hpp"
+
+#include <Dream/Events/Loop.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Posts count notifications from each of the given number of threads, and reports the throughput and the latency from posting each notification to processing it.
+		static void measure_producers (std::size_t producers, std::size_t count)
+		{
+			Ref<Loop> loop = new Loop;
+			loop->set_stop_when_idle(false);
+
+			std::unique_ptr<Histogram> latency(new Histogram);
+			std::size_t received = 0, total = producers * count;
+
+			std::atomic<bool> started(false);
+			std::vector<std::thread> threads;
+
+			for (std::size_t i = 0; i < producers; i += 1) {
+				threads.emplace_back([&](){
+					while (!started) std::this_thread::yield();
+
+					for (std::size_t j = 0; j < count; j += 1) {
+						std::uint64_t posted = Benchmark::timestamp();
+
+						loop->post_urgent([&, posted](Loop * loop){
+							latency->record(Benchmark::timestamp() - posted);
+
+							if (++received == total)
+								loop->stop();
+						});
+					}
+				});
+			}
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+			started = true;
+
+			loop->run_until_timeout(60);
+			TimeT duration = stopwatch.time();
+
+			for (auto & thread : threads)
+				thread.join();
+
+			Benchmark::report("post_urgent from " + std::to_string(producers) + " thread(s)", total, duration, *latency);
+		}
+
+		UnitTest::Suite NotificationsBenchmarkSuite {
+			"Dream::Events::Notifications",
+
+			{"throughput and latency of notifications from one or more producers",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t TOTAL = 1000000;
+
+					for (std::size_t producers = 1; producers <= 8; producers *= 2)
+						measure_producers(producers, TOTAL / producers);
+				}
+			},
+		};
+	}
+}
@@ -0,0 +1,178 @@
+//
+//  Benchmark.Post.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Channel.hpp>
+#include <Dream/Events/Loop.hpp>
+#include <Dream/Events/Source.hpp>
+#include <Dream/Core/Timer.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <vector>
+
+// Count allocations so that the benchmark can report how many each post performs:
+static std::atomic<std::size_t> allocations(0);
+
+void * operator new (std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void * pointer = std::malloc(size))
+		return pointer;
+
+	throw std::bad_alloc();
+}
+
+void operator delete (void * pointer) noexcept
+{
+	std::free(pointer);
+}
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Posts count items from a separate thread using the given function, which posts batch items at a time, and reports the throughput and allocations per item.
+		template <typename PostT>
+		static void measure (const char * name, std::size_t count, PostT post, std::size_t batch = 1)
+		{
+			auto event_loop = ref(new Loop);
+			event_loop->set_stop_when_idle(false);
+
+			std::size_t received = 0;
+			std::atomic<bool> started(false);
+
+			// Process items until all of them have been received:
+			std::function<void (Loop *)> done = [&](Loop * loop) {
+				received += 1;
+
+				if (received == count)
+					loop->stop();
+			};
+
+			// Warm up the node pool and the caches of the producing thread before measuring:
+			std::thread warmup([&](){
+				for (std::size_t i = 0; i < count; i += batch)
+					post(event_loop, done);
+			});
+
+			event_loop->run_until_timeout(60);
+			warmup.join();
+
+			received = 0;
+
+			Stopwatch stopwatch;
+			std::size_t initial_allocations = 0;
+
+			std::thread producer([&](){
+				while (!started) std::this_thread::yield();
+
+				for (std::size_t i = 0; i < count; i += batch)
+					post(event_loop, done);
+			});
+
+			initial_allocations = allocations.load();
+			stopwatch.start();
+			started = true;
+
+			event_loop->run_until_timeout(60);
+			TimeT duration = stopwatch.time();
+
+			producer.join();
+
+			std::size_t total_allocations = allocations.load() - initial_allocations;
+
+			std::cout << name << ": " << (count / duration) << " items/s, " << (double(total_allocations) / count) << " allocations/item" << std::endl;
+		}
+
+		UnitTest::Suite PostBenchmarkSuite {
+			"Dream::Events::Post",
+
+			{"post_notification with a NotificationSource compared to post_urgent with an inline function",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 1000000;
+
+					measure("post_notification", COUNT, [](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						loop->post_notification(new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+							done(loop);
+						}), true);
+					});
+
+					measure("post_urgent", COUNT, [](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						loop->post_urgent([&](Loop * loop){
+							done(loop);
+						});
+					});
+				}
+			},
+
+			{"post_notification compared to post_notifications in batches of 64",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 1000000, BATCH = 64;
+
+					// The sources are created by the first post, so that only the cost of posting them is measured:
+					Ref<INotificationSource> source;
+					std::vector<Ref<INotificationSource>> batch;
+
+					measure("post_notification with a shared source", COUNT, [&](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						if (!source) {
+							source = new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+								done(loop);
+							});
+						}
+
+						loop->post_notification(source, true);
+					});
+
+					source = nullptr;
+
+					measure("post_notifications with a shared source", COUNT, [&](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						if (batch.empty()) {
+							batch.assign(BATCH, new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+								done(loop);
+							}));
+						}
+
+						loop->post_notifications(batch.begin(), batch.end(), true);
+					}, BATCH);
+				}
+			},
+
+			{"post_urgent compared to sending items through a Channel",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 1000000;
+
+					measure("post_urgent", COUNT, [](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						loop->post_urgent([&](Loop * loop){
+							done(loop);
+						});
+					});
+
+					// The channel is created by the first send, as it is attached to the loop created by measure():
+					Ref<Channel<std::size_t>> channel;
+
+					measure("Channel::send", COUNT, [&](Ref<Loop> & loop, std::function<void (Loop *)> & done) {
+						if (!channel) {
+							channel = new Channel<std::size_t>(loop, [&](Loop * loop, std::vector<std::size_t> & items){
+								for (std::size_t i = 0; i < items.size(); i += 1)
+									done(loop);
+							});
+						}
+
+						channel->send(1);
+					});
+				}
+			},
+		};
+	}
+}
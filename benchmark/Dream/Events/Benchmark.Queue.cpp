@@ -0,0 +1,133 @@
+//
+//  Benchmark.Queue.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include "Benchmark.hpp"
+
+#include <Dream/Events/Thread.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Streams count items in total from the given number of producer threads to the calling thread, and reports the throughput. Each producer calls add(i) for each of its items, and the consumer calls fetch() until it returns the number of items received.
+		template <typename AddT, typename FetchT>
+		static void measure_queue (const std::string & name, std::size_t producers, std::size_t count, AddT add, FetchT fetch)
+		{
+			std::atomic<bool> started(false);
+			std::vector<std::thread> threads;
+
+			for (std::size_t producer = 0; producer < producers; producer += 1) {
+				threads.emplace_back([&](){
+					while (!started) std::this_thread::yield();
+
+					for (std::size_t i = 0; i < count / producers; i += 1)
+						add(i);
+				});
+			}
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+			started = true;
+
+			std::size_t received = 0, total = count / producers * producers;
+
+			while (received < total) {
+				std::size_t fetched = fetch();
+
+				if (fetched == 0)
+					std::this_thread::yield();
+
+				received += fetched;
+			}
+
+			TimeT duration = stopwatch.time();
+
+			for (auto & thread : threads)
+				thread.join();
+
+			Benchmark::report(name + " with " + std::to_string(producers) + " producers", total, duration);
+		}
+
+		UnitTest::Suite QueueBenchmarkSuite {
+			"Dream::Events::Queue",
+
+			{"streaming items through the double-buffered Queue compared to the bounded RingQueue",
+				[](UnitTest::Examiner & examiner) {
+					// A power of two, so that each producer adds whole batches:
+					const std::size_t COUNT = 1 << 20, BATCH = 256;
+
+					for (std::size_t producers : {1, 4, 16}) {
+						Ref<Queue<std::size_t>> queue = new Queue<std::size_t>;
+
+						measure_queue("Queue", producers, COUNT, [&](std::size_t i) {
+							queue->add(i);
+						}, [&]() {
+							return queue->fetch()->size();
+						});
+
+						Ref<RingQueue<std::size_t>> ring = new RingQueue<std::size_t>(4096);
+						std::vector<std::size_t> items(BATCH);
+
+						measure_queue("RingQueue", producers, COUNT, [&](std::size_t i) {
+							// Backpressure: wait for the consumer to make space:
+							while (!ring->try_add(i))
+								std::this_thread::yield();
+						}, [&]() {
+							return ring->fetch(items.data(), items.size());
+						});
+
+						if (producers == 1) {
+							Ref<RingQueue<std::size_t, SINGLE_PRODUCER>> single = new RingQueue<std::size_t, SINGLE_PRODUCER>(4096);
+
+							measure_queue("RingQueue (single producer)", producers, COUNT, [&](std::size_t i) {
+								while (!single->try_add(i))
+									std::this_thread::yield();
+							}, [&]() {
+								return single->fetch(items.data(), items.size());
+							});
+						}
+
+						// Producers which have items ready in batches can reserve space for a whole batch at once:
+						Ref<RingQueue<std::size_t>> batched = new RingQueue<std::size_t>(4096);
+
+						measure_queue("RingQueue (batches of 16)", producers, COUNT, [&](std::size_t i) {
+							thread_local std::size_t batch[16];
+							thread_local std::size_t size = 0;
+
+							batch[size++] = i;
+
+							if (size == 16) {
+								std::size_t * begin = batch, * end = batch + size;
+
+								while (begin != end) {
+									std::size_t added = batched->try_add(begin, end);
+
+									if (added == 0)
+										std::this_thread::yield();
+
+									begin += added;
+								}
+
+								size = 0;
+							}
+						}, [&]() {
+							return batched->fetch(items.data(), items.size());
+						});
+					}
+				}
+			},
+		};
+	}
+}
@@ -0,0 +1,101 @@
+//
+//  Benchmark.Timers.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include "Benchmark.hpp"
+
+#include <Dream/Events/Loop.hpp>
+
+namespace Dream
+{
+	namespace Events
+	{
+		static const char * timer_queue_name (TimerQueueType type)
+		{
+			switch (type) {
+				case TIMER_HEAP: return "heap";
+				case TIMER_WHEEL: return "wheel";
+				case TIMER_HYBRID: return "hybrid";
+			}
+
+			return "unknown";
+		}
+
+		/// Schedules count timers spread evenly over the given duration, and returns how long it took to schedule them.
+		static TimeT schedule_timers (Ref<Loop> loop, std::size_t count, TimeT spread, std::size_t & fired)
+		{
+			// Timers are only scheduled directly when called on the loop thread:
+			loop->run_once(false);
+
+			std::function<void (Loop *, TimerSource *, Event)> callback = [&](Loop * loop, TimerSource *, Event) {
+				fired += 1;
+			};
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+
+			for (std::size_t i = 0; i < count; i += 1)
+				loop->schedule_timer(new TimerSource(callback, spread * i / count));
+
+			return stopwatch.time();
+		}
+
+		/// Schedules count timers which are due within 10ms, and reports how quickly they can be scheduled, and how quickly they are processed once they are all due. Then, schedules count timers which are due within 100ms while the loop is running, and reports how late they fire.
+		static void measure_timers (TimerQueueType type, std::size_t count)
+		{
+			const TimeT SPREAD = 0.01, LIVE_SPREAD = 0.1;
+
+			Ref<Loop> loop = new Loop;
+			loop->set_timer_queue(type);
+
+			std::size_t fired = 0;
+			TimeT schedule_duration = schedule_timers(loop, count, SPREAD, fired);
+
+			// Wait until all the timers are due, so that only processing is measured:
+			if (schedule_duration < SPREAD)
+				Core::sleep(SPREAD - schedule_duration);
+
+			Stopwatch stopwatch;
+			stopwatch.start();
+			loop->run_until_timeout(60);
+			TimeT fire_duration = stopwatch.time();
+
+			// The lateness of timers which were all due before the loop ran isn't meaningful, so it is measured separately:
+			Ref<Loop> live = new Loop;
+			live->set_timer_queue(type);
+
+			std::size_t fired_live = 0;
+			schedule_timers(live, count, LIVE_SPREAD, fired_live);
+
+			stopwatch.start();
+			live->run_until_timeout(60);
+			TimeT live_duration = stopwatch.time();
+
+			std::string name = std::string(timer_queue_name(type)) + " with " + std::to_string(count) + " timers";
+
+			Benchmark::report(name + ": schedule_timer", count, schedule_duration);
+			Benchmark::report(name + ": fire", fired, fire_duration);
+			Benchmark::report(name + ": fire while running (lateness)", fired_live, live_duration, live->metrics().timer_lateness);
+		}
+
+		UnitTest::Suite TimersBenchmarkSuite {
+			"Dream::Events::Timers",
+
+			{"scheduling and firing timers with each timer queue",
+				[](UnitTest::Examiner & examiner) {
+					for (std::size_t count = 1000; count <= 1000000; count *= 10) {
+						measure_timers(TIMER_HEAP, count);
+						measure_timers(TIMER_WHEEL, count);
+						measure_timers(TIMER_HYBRID, count);
+					}
+				}
+			},
+		};
+	}
+}
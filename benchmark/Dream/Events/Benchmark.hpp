@@ -0,0 +1,53 @@
+//
+//  Benchmark.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include <Dream/Events/Metrics.hpp>
+#include <Dream/Events/Trace.hpp>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Helpers shared by the benchmarks, so that they report results in the same format.
+		namespace Benchmark
+		{
+			/// A timestamp in nanoseconds which can be compared between threads.
+			inline std::uint64_t timestamp ()
+			{
+				return Trace::now();
+			}
+
+			/// Report the throughput of count operations over the given duration, and the distribution of their latency in nanoseconds, if any were recorded.
+			inline void report (const std::string & name, std::size_t count, TimeT duration, const Histogram & latency)
+			{
+				std::cout << name << ": " << std::uint64_t(count / duration) << " items/s" << std::fixed << std::setprecision(2);
+
+				if (latency.count()) {
+					std::cout << ", latency p50 " << (latency.percentile(50) / 1000.0) << "us"
+						<< ", p99 " << (latency.percentile(99) / 1000.0) << "us"
+						<< ", p999 " << (latency.percentile(99.9) / 1000.0) << "us";
+				}
+
+				std::cout << std::endl;
+			}
+
+			inline void report (const std::string & name, std::size_t count, TimeT duration)
+			{
+				Histogram latency;
+
+				report(name, count, duration, latency);
+			}
+		}
+	}
+}
@@ -0,0 +1,205 @@
+//
+//  Acceptor.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Acceptor.hpp"
+#include "Thread.hpp"
+
+#include <Dream/Core/Logger.hpp>
+#include <Dream/Core/System.hpp>
+
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		using namespace Logging;
+
+// MARK: -
+// MARK: class AcceptorSource
+
+		// How long accepting is paused after a failure:
+		static const TimeT PAUSE_DURATION = 0.1;
+
+		AcceptorSource::AcceptorSource (CallbackT callback, FileDescriptor file_descriptor) : _file_descriptor(file_descriptor), _callback(callback), _paused(false), _logged_at(-1)
+		{
+			set_will_block(false);
+		}
+
+		AcceptorSource::~AcceptorSource ()
+		{
+			if (_file_descriptor != -1)
+				::close(_file_descriptor);
+		}
+
+		FileDescriptor AcceptorSource::file_descriptor () const
+		{
+			return _file_descriptor;
+		}
+
+		/// Accept a connection as a non-blocking file descriptor which isn't inherited by child processes.
+		static FileDescriptor accept_connection (FileDescriptor file_descriptor)
+		{
+#if defined(TARGET_OS_LINUX)
+			return accept4(file_descriptor, nullptr, nullptr, SOCK_NONBLOCK|SOCK_CLOEXEC);
+#else
+			FileDescriptor connection = accept(file_descriptor, nullptr, nullptr);
+
+			if (connection != -1) {
+				fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK);
+				fcntl(connection, F_SETFD, FD_CLOEXEC);
+			}
+
+			return connection;
+#endif
+		}
+
+		void AcceptorSource::process_events (Loop * loop, Event event)
+		{
+			if (event != READ_READY)
+				return;
+
+			// Accept all pending connections, as there may be many for each time the socket becomes readable:
+			while (true) {
+				FileDescriptor connection = accept_connection(_file_descriptor);
+
+				if (connection == -1) {
+					int error = errno;
+
+					// The connection was reset or aborted before it was accepted:
+					if (error == EINTR || error == ECONNABORTED || error == EPROTO)
+						continue;
+
+					if (error == EAGAIN || error == EWOULDBLOCK)
+						break;
+
+					TimeT current_time = loop->stopwatch().time();
+
+					if (_logged_at < 0 || current_time - _logged_at >= 1.0) {
+						log_error("Could not accept connection:", system_error_description(error));
+						_logged_at = current_time;
+					}
+
+					// The connection is still waiting, e.g. for a file descriptor to become available, so the socket would be reported as readable by every iteration of the loop:
+					pause(loop);
+
+					break;
+				}
+
+				_callback(loop, this, connection);
+			}
+		}
+
+		void AcceptorSource::pause (Loop * loop)
+		{
+			if (_paused)
+				return;
+
+			_paused = true;
+			loop->set_interest(this, 0);
+
+			Ref<AcceptorSource> acceptor = this;
+
+			// If the socket has been removed from the loop in the mean time, this has no effect:
+			loop->schedule_timer(new TimerSource([acceptor](Loop * loop, TimerSource *, Event) {
+				acceptor->_paused = false;
+				loop->set_interest(acceptor, READ_READY);
+			}, PAUSE_DURATION));
+		}
+
+// MARK: -
+// MARK: class ShardedAcceptor
+
+		/// Open a listening socket which shares its address with other sockets.
+		static FileDescriptor open_shard (const sockaddr * address, socklen_t address_length, int backlog)
+		{
+			SystemError::reset();
+
+			FileDescriptor file_descriptor = socket(address->sa_family, SOCK_STREAM, 0);
+
+			if (file_descriptor == -1)
+				SystemError::check("socket");
+
+			int enable = 1;
+			const char * operation = nullptr;
+
+			if (setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) == -1)
+				operation = "setsockopt(SO_REUSEADDR)";
+			else if (setsockopt(file_descriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == -1)
+				operation = "setsockopt(SO_REUSEPORT)";
+			else if (bind(file_descriptor, address, address_length) == -1)
+				operation = "bind";
+			else if (listen(file_descriptor, backlog) == -1)
+				operation = "listen";
+
+			if (operation) {
+				int error = errno;
+				::close(file_descriptor);
+				errno = error;
+
+				SystemError::check(operation);
+			}
+
+			fcntl(file_descriptor, F_SETFD, FD_CLOEXEC);
+
+			return file_descriptor;
+		}
+
+		ShardedAcceptor::ShardedAcceptor (std::vector<Ref<Loop>> loops, const sockaddr * address, socklen_t address_length, AcceptorSource::CallbackT callback, int backlog) : _loops(loops), _address_length(address_length)
+		{
+			DREAM_ASSERT(address_length <= sizeof(_address));
+			DREAM_ASSERT(address->sa_family == AF_INET || address->sa_family == AF_INET6);
+
+			std::memcpy(&_address, address, address_length);
+
+			for (std::size_t i = 0; i < _loops.size(); i += 1) {
+				FileDescriptor file_descriptor = open_shard(this->address(), _address_length, backlog);
+
+				// If the port was chosen by the system, the remaining sockets need to use the same one:
+				if (i == 0 && getsockname(file_descriptor, (sockaddr *)&_address, &_address_length) == -1) {
+					int error = errno;
+					::close(file_descriptor);
+					errno = error;
+
+					SystemError::check("getsockname");
+				}
+
+				_shards.push_back(new AcceptorSource(callback, file_descriptor));
+			}
+
+			for (std::size_t i = 0; i < _loops.size(); i += 1) {
+				Ref<AcceptorSource> shard = _shards[i];
+
+				_loops[i]->post_urgent([shard](Loop * loop) {
+					loop->monitor(shard, READ_READY);
+				});
+			}
+		}
+
+		ShardedAcceptor::~ShardedAcceptor ()
+		{
+			close();
+		}
+
+		void ShardedAcceptor::close ()
+		{
+			for (std::size_t i = 0; i < _shards.size(); i += 1) {
+				Ref<AcceptorSource> shard = _shards[i];
+
+				_loops[i]->post_urgent([shard](Loop * loop) {
+					loop->stop_monitoring_file_descriptor(shard);
+				});
+			}
+
+			_shards.clear();
+		}
+	}
+}
@@ -0,0 +1,74 @@
+//
+//  Acceptor.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Loop.hpp"
+
+#include <vector>
+
+#include <sys/socket.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Accepts connections from a listening socket. When the socket is readable, connections are accepted in a batch until the socket would block, and each one is passed to the callback as a non-blocking file descriptor which the callback takes ownership of. If a connection can't be accepted, e.g. because the process has run out of file descriptors, the socket stays readable, so accepting is paused for a short time rather than retried by every iteration of the loop.
+		class AcceptorSource : public Object, virtual public IFileDescriptorSource {
+		public:
+			typedef std::function<void (Loop *, AcceptorSource *, FileDescriptor)> CallbackT;
+
+		protected:
+			FileDescriptor _file_descriptor;
+			CallbackT _callback;
+
+			bool _paused;
+
+			// The time the last failure was logged, so that failures are logged at most once per second:
+			TimeT _logged_at;
+
+			/// Stop monitoring the socket for a short time.
+			void pause (Loop * loop);
+
+		public:
+			/// Takes ownership of the listening socket, which is made non-blocking.
+			AcceptorSource (CallbackT callback, FileDescriptor file_descriptor);
+			virtual ~AcceptorSource ();
+
+			virtual FileDescriptor file_descriptor () const;
+
+			virtual void process_events (Loop *, Event);
+		};
+
+		/// Listens on the same address with one socket per loop, using SO_REUSEPORT so that the kernel distributes incoming connections between the loops, rather than accepting every connection on one thread and handing it off. The callback is invoked on the loop which accepted the connection. Only TCP (IPv4 and IPv6) addresses are supported, as SO_REUSEPORT doesn't apply to UNIX sockets.
+		class ShardedAcceptor : public Object {
+		protected:
+			std::vector<Ref<Loop>> _loops;
+			std::vector<Ref<AcceptorSource>> _shards;
+
+			sockaddr_storage _address;
+			socklen_t _address_length;
+
+		public:
+			/// Opens and binds one listening socket for each loop, and monitors each socket on its loop by sending an urgent notification. If the port is 0, all sockets are bound to the port chosen for the first one. Throws a SystemError if a socket can't be opened or bound.
+			ShardedAcceptor (std::vector<Ref<Loop>> loops, const sockaddr * address, socklen_t address_length, AcceptorSource::CallbackT callback, int backlog = SOMAXCONN);
+
+			/// Stops accepting connections.
+			virtual ~ShardedAcceptor ();
+
+			/// The address the sockets are bound to.
+			const sockaddr * address () const { return (const sockaddr *)&_address; }
+			socklen_t address_length () const { return _address_length; }
+
+			std::size_t size () const { return _shards.size(); }
+
+			/// Stop monitoring the listening sockets, which are closed once they have been removed from their loops. This function is thread-safe.
+			void close ();
+		};
+	}
+}
@@ -0,0 +1,139 @@
+//
+//  Channel.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Loop.hpp"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Send items from any number of threads to a callback on a loop. Items are delivered in batches: the callback is invoked with all the items sent since it was last invoked, in the order they were sent, so a single notification is used for the whole batch rather than one for each item. The loop is only notified when an item is sent to an empty channel.
+		/// The channel doesn't retain the loop, as the loop retains the channel while a batch is waiting to be delivered. The loop must outlive any calls to send(). If the loop is destroyed before a batch is delivered, the loop releases the channel and the items are destroyed with it.
+		template <typename ItemT>
+		class Channel : public Object {
+		public:
+			/// The callback can move items out of the batch. Any items left in it are destroyed once the callback returns.
+			typedef std::function<void (Loop *, std::vector<ItemT> & items)> CallbackT;
+
+		protected:
+			Ptr<Loop> _loop;
+			CallbackT _callback;
+
+			std::mutex _lock;
+			std::vector<ItemT> _waiting;
+
+			// The batch being delivered, which is kept so that its capacity is reused by later batches:
+			std::vector<ItemT> _delivering;
+
+			/// Notify the loop if the channel was empty. The loop is notified after the lock is released, so that senders don't wait for it.
+			void notify (bool was_empty);
+
+			/// Invoked on the loop thread to deliver all waiting items.
+			void deliver (Loop * loop);
+
+		public:
+			Channel (Ptr<Loop> loop, CallbackT callback);
+
+			Ptr<Loop> loop () const { return _loop; }
+
+			/// Send an item to the loop. This function is thread-safe. If called from the loop thread, the item is delivered after the caller returns, so the callback is never re-entered.
+			void send (ItemT && item);
+			void send (const ItemT & item);
+
+			/// Send a range of items, which are moved from the range, with a single lock and at most one notification. This function is thread-safe.
+			template <typename IteratorT>
+			void send (IteratorT begin, IteratorT end);
+		};
+
+		template <typename ItemT>
+		Channel<ItemT>::Channel (Ptr<Loop> loop, CallbackT callback) : _loop(loop), _callback(callback)
+		{
+		}
+
+		template <typename ItemT>
+		void Channel<ItemT>::notify (bool was_empty)
+		{
+			if (was_empty) {
+				// The function keeps the channel alive until the items have been delivered:
+				Ref<Channel> channel(this);
+
+				_loop->defer([channel](Loop * loop) {
+					channel->deliver(loop);
+				});
+			}
+		}
+
+		template <typename ItemT>
+		void Channel<ItemT>::send (ItemT && item)
+		{
+			bool was_empty;
+
+			{
+				std::lock_guard<std::mutex> lock(_lock);
+
+				was_empty = _waiting.empty();
+				_waiting.push_back(std::move(item));
+			}
+
+			notify(was_empty);
+		}
+
+		template <typename ItemT>
+		void Channel<ItemT>::send (const ItemT & item)
+		{
+			send(ItemT(item));
+		}
+
+		template <typename ItemT>
+		template <typename IteratorT>
+		void Channel<ItemT>::send (IteratorT begin, IteratorT end)
+		{
+			if (begin == end)
+				return;
+
+			bool was_empty;
+
+			{
+				std::lock_guard<std::mutex> lock(_lock);
+
+				was_empty = _waiting.empty();
+
+				for (; begin != end; ++begin)
+					_waiting.push_back(std::move(*begin));
+			}
+
+			notify(was_empty);
+		}
+
+		template <typename ItemT>
+		void Channel<ItemT>::deliver (Loop * loop)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_lock);
+
+				// Items sent after this point will notify the loop again:
+				std::swap(_waiting, _delivering);
+			}
+
+			// The batch is cleared even if the callback throws, so that the items aren't delivered again with the next batch:
+			struct Clear {
+				std::vector<ItemT> & items;
+
+				~Clear () { items.clear(); }
+			} clear = {_delivering};
+
+			_callback(loop, _delivering);
+		}
+	}
+}
@@ -0,0 +1,400 @@
+//
+//  Coroutine.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Loop.hpp"
+
+// Coroutines require C++20, the rest of the library only requires C++11:
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#define DREAM_EVENTS_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// A coroutine which starts running immediately and destroys itself when it finishes. Use it as the return type of coroutines which await events on a loop.
+		struct Task {
+			struct promise_type {
+				Task get_return_object () noexcept { return Task(); }
+
+				std::suspend_never initial_suspend () noexcept { return {}; }
+				std::suspend_never final_suspend () noexcept { return {}; }
+
+				void return_void () noexcept {}
+
+				// There is nobody to report the exception to:
+				void unhandled_exception () noexcept { std::terminate(); }
+			};
+		};
+
+		/// A file descriptor which coroutines can wait on. It is monitored by the loop the first time it is awaited, and coroutines are resumed directly when the loop dispatches the event, so awaiting doesn't allocate. At most one coroutine can wait for each event at a time. This class is NOT thread-safe and must only be used on the loop thread.
+		class AsyncFileDescriptor : public Object, virtual public IFileDescriptorSource {
+		protected:
+			Ref<Loop> _loop;
+			FileDescriptor _file_descriptor;
+
+			bool _monitored;
+			int _events;
+
+			std::coroutine_handle<> _reader, _writer;
+
+		public:
+			struct Awaiter {
+				AsyncFileDescriptor * file;
+				int event;
+
+				bool await_ready () const noexcept { return false; }
+				void await_suspend (std::coroutine_handle<> handle) { file->wait(event, handle); }
+				void await_resume () const noexcept {}
+			};
+
+			/// Doesn't take ownership of the file descriptor.
+			AsyncFileDescriptor (Ref<Loop> loop, FileDescriptor file_descriptor) : _loop(loop), _file_descriptor(file_descriptor), _monitored(false), _events(0)
+			{
+			}
+
+			virtual ~AsyncFileDescriptor ()
+			{
+			}
+
+			virtual FileDescriptor file_descriptor () const
+			{
+				return _file_descriptor;
+			}
+
+			/// Suspend until the file descriptor is readable.
+			Awaiter readable () { return Awaiter{this, READ_READY}; }
+
+			/// Suspend until the file descriptor is writable.
+			Awaiter writable () { return Awaiter{this, WRITE_READY}; }
+
+			/// Resume the coroutine when the given event occurs.
+			void wait (int event, std::coroutine_handle<> handle)
+			{
+				DREAM_ASSERT(event == READ_READY || event == WRITE_READY);
+
+				if (event == READ_READY)
+					_reader = handle;
+				else
+					_writer = handle;
+
+				_events |= event;
+
+				if (_monitored) {
+					_loop->set_interest(this, _events);
+				} else {
+					_loop->monitor(this, _events);
+					_monitored = true;
+				}
+			}
+
+			/// Stop monitoring the file descriptor. Any waiting coroutines are never resumed. The loop holds a reference to the file descriptor while it is monitored, so this must be called to release it.
+			void stop ()
+			{
+				if (_monitored) {
+					_loop->stop_monitoring_file_descriptor(this);
+					_monitored = false;
+				}
+
+				_reader = _writer = nullptr;
+				_events = 0;
+			}
+
+			virtual void process_events (Loop * loop, Event event)
+			{
+				std::coroutine_handle<> reader, writer;
+
+				if (event & READ_READY) {
+					reader = _reader;
+					_reader = nullptr;
+				}
+
+				if (event & WRITE_READY) {
+					writer = _writer;
+					_writer = nullptr;
+				}
+
+				if (!reader && !writer)
+					return;
+
+				// The interest is updated before resuming, as the coroutine will typically wait again, and interest changes made during dispatch are coalesced:
+				_events &= ~event;
+				loop->set_interest(this, _events);
+
+				if (reader)
+					reader.resume();
+
+				if (writer)
+					writer.resume();
+			}
+		};
+
+		/// A source which is stored in an awaiter, and so lives in the frame of the suspended coroutine, which means awaiting doesn't allocate. The references held by the loop are counted, but releasing the last one doesn't delete the source. The loop may still refer to the source after the event, e.g. while a monitor retires it, so the coroutine is resumed by a deferred function once the event has occurred and the loop has released the source. Must only be used on the loop thread.
+		class AwaiterSource : public Object {
+		protected:
+			Loop * _loop;
+			std::coroutine_handle<> _handle;
+
+			mutable std::size_t _references;
+			mutable bool _ready;
+
+			void resume () const
+			{
+				_ready = false;
+
+				std::coroutine_handle<> handle = _handle;
+
+				_loop->defer([handle](Loop *) {
+					handle.resume();
+				});
+			}
+
+			/// The event has occurred, resume the coroutine once the loop has released the source.
+			void ready ()
+			{
+				_ready = true;
+
+				if (_references == 0)
+					resume();
+			}
+
+		public:
+			AwaiterSource (Loop * loop) : _loop(loop), _references(0), _ready(false)
+			{
+			}
+
+			virtual ~AwaiterSource ()
+			{
+				DREAM_ASSERT(_references == 0);
+			}
+
+			void suspend (std::coroutine_handle<> handle)
+			{
+				_handle = handle;
+			}
+
+			virtual void retain () const
+			{
+				_references += 1;
+			}
+
+			virtual bool release () const
+			{
+				DREAM_ASSERT(_references > 0);
+
+				_references -= 1;
+
+				if (_references == 0 && _ready)
+					resume();
+
+				return false;
+			}
+		};
+
+		class FileDescriptorAwaiter {
+		protected:
+			class Source : public AwaiterSource, virtual public IFileDescriptorSource {
+			protected:
+				FileDescriptor _file_descriptor;
+
+			public:
+				Source (Loop * loop, FileDescriptor file_descriptor) : AwaiterSource(loop), _file_descriptor(file_descriptor)
+				{
+				}
+
+				virtual FileDescriptor file_descriptor () const
+				{
+					return _file_descriptor;
+				}
+
+				virtual void process_events (Loop * loop, Event event)
+				{
+					if (_ready)
+						return;
+
+					ready();
+
+					loop->stop_monitoring_file_descriptor(this);
+				}
+			};
+
+			Ref<Loop> _loop;
+			Source _source;
+			int _event;
+
+		public:
+			FileDescriptorAwaiter (Ref<Loop> loop, FileDescriptor file_descriptor, int event) : _loop(loop), _source(loop.get(), file_descriptor), _event(event)
+			{
+			}
+
+			bool await_ready () const noexcept { return false; }
+
+			void await_suspend (std::coroutine_handle<> handle)
+			{
+				_source.suspend(handle);
+				_loop->monitor(&_source, _event);
+			}
+
+			void await_resume () const noexcept {}
+		};
+
+		/// Suspend until the file descriptor is readable. The source is stored in the coroutine frame, so this doesn't allocate. AsyncFileDescriptor is more efficient for waiting on the same file descriptor repeatedly, as it is only monitored once. Must be awaited on the loop thread.
+		inline FileDescriptorAwaiter readable (Ref<Loop> loop, FileDescriptor file_descriptor)
+		{
+			return FileDescriptorAwaiter(loop, file_descriptor, READ_READY);
+		}
+
+		/// Suspend until the file descriptor is writable. See readable().
+		inline FileDescriptorAwaiter writable (Ref<Loop> loop, FileDescriptor file_descriptor)
+		{
+			return FileDescriptorAwaiter(loop, file_descriptor, WRITE_READY);
+		}
+
+		class SleepAwaiter {
+		protected:
+			class Source : public AwaiterSource, virtual public ITimerSource {
+			protected:
+				TimeT _duration;
+
+			public:
+				Source (Loop * loop, TimeT duration) : AwaiterSource(loop), _duration(duration)
+				{
+				}
+
+				virtual bool repeats () const
+				{
+					return false;
+				}
+
+				virtual TimeT next_timeout (const TimeT & last_timeout, const TimeT & current_time) const
+				{
+					return last_timeout + _duration;
+				}
+
+				virtual void process_events (Loop * loop, Event event)
+				{
+					ready();
+				}
+			};
+
+			Ref<Loop> _loop;
+			TimeT _duration;
+			Source _source;
+
+		public:
+			SleepAwaiter (Ref<Loop> loop, TimeT duration) : _loop(loop), _duration(duration), _source(loop.get(), duration)
+			{
+			}
+
+			bool await_ready () const noexcept { return _duration <= 0; }
+
+			void await_suspend (std::coroutine_handle<> handle)
+			{
+				_source.suspend(handle);
+				_loop->schedule_timer(&_source);
+			}
+
+			void await_resume () const noexcept {}
+		};
+
+		/// Suspend for the given duration using the timer queue of the loop. The timer source is stored in the coroutine frame, so this doesn't allocate. Must be awaited on the loop thread.
+		inline SleepAwaiter sleep_for (Ref<Loop> loop, TimeT duration)
+		{
+			return SleepAwaiter(loop, duration);
+		}
+
+		struct ResumeOnAwaiter {
+			Ref<Loop> loop;
+
+			// Continue without suspending if already running on the loop:
+			bool await_ready () const noexcept { return loop->on_loop_thread(); }
+
+			void await_suspend (std::coroutine_handle<> handle)
+			{
+				loop->post_urgent([handle](Loop *) {
+					handle.resume();
+				});
+			}
+
+			void await_resume () const noexcept {}
+		};
+
+		/// Continue the coroutine on the thread of the given loop. This uses Loop::post_urgent(), so it doesn't allocate. This function is thread-safe.
+		inline ResumeOnAwaiter resume_on (Ref<Loop> loop)
+		{
+			return ResumeOnAwaiter{loop};
+		}
+
+		template <typename FunctionT, typename ResultT = typename Future<FunctionT>::ResultT>
+		struct FutureAwaiter {
+			Future<FunctionT> future;
+			std::optional<ResultT> result = {};
+			std::exception_ptr error = {};
+
+			bool await_ready () const noexcept { return false; }
+
+			void await_suspend (std::coroutine_handle<> handle)
+			{
+				future.then(Loop::current(), [this, handle](Loop *, ResultT value) {
+					result.emplace(std::move(value));
+					handle.resume();
+				}, [this, handle](Loop *, std::exception_ptr exception) {
+					error = exception;
+					handle.resume();
+				});
+			}
+
+			ResultT await_resume ()
+			{
+				if (error)
+					std::rethrow_exception(error);
+
+				return std::move(*result);
+			}
+		};
+
+		template <typename FunctionT>
+		struct FutureAwaiter<FunctionT, void> {
+			Future<FunctionT> future;
+			std::exception_ptr error = {};
+
+			bool await_ready () const noexcept { return false; }
+
+			void await_suspend (std::coroutine_handle<> handle)
+			{
+				future.then(Loop::current(), [handle](Loop *) {
+					handle.resume();
+				}, [this, handle](Loop *, std::exception_ptr exception) {
+					error = exception;
+					handle.resume();
+				});
+			}
+
+			void await_resume ()
+			{
+				if (error)
+					std::rethrow_exception(error);
+			}
+		};
+
+		/// Invoke the function on the target loop and resume the coroutine with the result on the current loop, e.g. auto result = co_await loop->invoke(function). If the function throws an exception, it is rethrown in the coroutine. Must be awaited on a loop thread.
+		template <typename FunctionT>
+		FutureAwaiter<FunctionT> operator co_await (Future<FunctionT> future)
+		{
+			return FutureAwaiter<FunctionT>{std::move(future)};
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,196 @@
+//
+//  Executor.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Executor.hpp"
+
+#include <Dream/Core/Logger.hpp>
+
+#include <algorithm>
+
+namespace Dream
+{
+	namespace Events
+	{
+		using namespace Logging;
+
+		// The executor and worker of the current thread, if it is a worker thread:
+		static thread_local Executor * current_executor = nullptr;
+		static thread_local std::size_t current_worker = 0;
+
+		Executor::Executor (std::size_t count) : _queued(0), _executed(0), _stolen(0), _next(0), _sleeping(0), _stopping(false)
+		{
+			if (count == 0)
+				count = std::max(1u, std::thread::hardware_concurrency());
+
+			for (std::size_t i = 0; i < count; i += 1)
+				_workers.emplace_back(new Worker);
+
+			// Workers are started once all deques exist, as they may steal from each other immediately:
+			for (std::size_t i = 0; i < count; i += 1)
+				_workers[i]->thread = std::thread(std::bind(&Executor::run, this, i));
+		}
+
+		Executor::~Executor ()
+		{
+			stop();
+		}
+
+		void Executor::submit (TaskT task)
+		{
+			// Counted before the task is added, so that the count can't be decremented by a worker first, and so that the workers don't exit before the task is added:
+			_queued.fetch_add(1);
+
+			// The workers may have exited, so the task is run on the calling thread instead of being dropped:
+			if (_stopping.load()) {
+				_queued.fetch_sub(1);
+
+				// Workers which are finishing wait for the count to reach zero:
+				{
+					std::lock_guard<std::mutex> lock(_lock);
+					_condition.notify_all();
+				}
+
+				run_task(task);
+
+				return;
+			}
+
+			std::size_t index;
+
+			// Tasks submitted by a worker are run by the same worker if possible, as their data is likely to be in its cache:
+			if (current_executor == this)
+				index = current_worker;
+			else
+				index = _next.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+
+			Worker & worker = *_workers[index];
+
+			{
+				std::lock_guard<std::mutex> lock(worker.lock);
+				worker.tasks.push_back(std::move(task));
+			}
+
+			// This is sequentially consistent with the sleeping count, so that a worker which is going to sleep either sees the task or is woken up:
+			if (_sleeping.load() > 0) {
+				std::lock_guard<std::mutex> lock(_lock);
+				_condition.notify_one();
+			}
+		}
+
+		bool Executor::pop (std::size_t index, TaskT & task)
+		{
+			Worker & worker = *_workers[index];
+			std::lock_guard<std::mutex> lock(worker.lock);
+
+			if (worker.tasks.empty())
+				return false;
+
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+
+			return true;
+		}
+
+		bool Executor::steal (std::size_t index, TaskT & task)
+		{
+			for (std::size_t offset = 1; offset < _workers.size(); offset += 1) {
+				Worker & victim = *_workers[(index + offset) % _workers.size()];
+				std::lock_guard<std::mutex> lock(victim.lock);
+
+				if (!victim.tasks.empty()) {
+					task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+
+					_stolen.fetch_add(1, std::memory_order_relaxed);
+
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Executor::run (std::size_t index)
+		{
+			current_executor = this;
+			current_worker = index;
+
+			TaskT task;
+
+			while (true) {
+				if (pop(index, task) || steal(index, task)) {
+					_queued.fetch_sub(1);
+
+					run_task(task);
+					task = nullptr;
+
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(_lock);
+
+				_sleeping.fetch_add(1);
+
+				_condition.wait(lock, [&]() {
+					return _stopping || _queued.load() > 0;
+				});
+
+				_sleeping.fetch_sub(1);
+
+				// All submitted tasks are run before stopping:
+				if (_stopping && _queued.load() == 0)
+					break;
+			}
+
+			current_executor = nullptr;
+		}
+
+		void Executor::run_task (TaskT & task)
+		{
+			try {
+				task();
+			} catch (std::exception & error) {
+				log_error("Executor task failed:", error.what());
+			} catch (...) {
+				log_error("Executor task failed with an unknown exception!");
+			}
+
+			_executed.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Executor::stop ()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_lock);
+
+				if (_stopping)
+					return;
+
+				_stopping = true;
+			}
+
+			_condition.notify_all();
+
+			for (auto & worker : _workers) {
+				if (worker->thread.joinable())
+					worker->thread.join();
+			}
+		}
+
+		Executor::Statistics Executor::statistics () const
+		{
+			Statistics statistics;
+
+			statistics.queued = _queued.load(std::memory_order_relaxed);
+			statistics.executed = _executed.load(std::memory_order_relaxed);
+			statistics.stolen = _stolen.load(std::memory_order_relaxed);
+
+			return statistics;
+		}
+	}
+}
@@ -0,0 +1,145 @@
+//
+//  Executor.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Loop.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Run CPU intensive tasks on a pool of worker threads, so that they don't stall an event-loop. Each worker has its own deque of tasks: tasks submitted by a worker are added to its own deque and run most recent first, while idle workers steal the oldest tasks from other workers.
+		class Executor : public Object {
+		public:
+			typedef std::function<void ()> TaskT;
+
+			struct Statistics {
+				/// The number of tasks waiting to be run.
+				std::size_t queued;
+				/// The number of tasks which have been run.
+				std::size_t executed;
+				/// The number of tasks which were taken from the deque of a different worker.
+				std::size_t stolen;
+			};
+
+		protected:
+			struct Worker {
+				std::mutex lock;
+				std::deque<TaskT> tasks;
+				std::thread thread;
+			};
+
+			std::vector<std::unique_ptr<Worker>> _workers;
+
+			std::atomic<std::size_t> _queued, _executed, _stolen, _next;
+
+			// Idle workers wait on the condition, which is only signalled if there are sleeping workers:
+			std::mutex _lock;
+			std::condition_variable _condition;
+			std::atomic<std::size_t> _sleeping;
+			std::atomic<bool> _stopping;
+
+			void run (std::size_t index);
+			void run_task (TaskT & task);
+
+			bool pop (std::size_t index, TaskT & task);
+			bool steal (std::size_t index, TaskT & task);
+
+			template <typename FailureT>
+			static void fail (Ref<Loop> & loop, FailureT & failure, std::exception_ptr error)
+			{
+				loop->post_urgent([failure, error](Loop * loop) mutable {
+					failure(loop, error);
+				});
+			}
+
+			template <typename ResultT>
+			struct Completion {
+				template <typename FunctionT, typename CompletionT, typename FailureT>
+				static TaskT wrap (FunctionT function, Ref<Loop> loop, CompletionT completion, FailureT failure)
+				{
+					return [function, loop, completion, failure]() mutable {
+						try {
+							ResultT result = function();
+
+							loop->post_urgent([completion, result](Loop * loop) mutable {
+								completion(loop, std::move(result));
+							});
+						} catch (...) {
+							fail(loop, failure, std::current_exception());
+						}
+					};
+				}
+			};
+
+		public:
+			/// If count is 0, one worker is created for each hardware thread.
+			Executor (std::size_t count = 0);
+
+			/// Waits for all submitted tasks to finish.
+			virtual ~Executor ();
+
+			std::size_t size () const { return _workers.size(); }
+
+			/// Run a task on one of the workers. If the executor has been stopped, the task is run immediately on the calling thread instead. This function is thread-safe.
+			void submit (TaskT task);
+
+			/// Run a task on one of the workers, and then invoke the completion on the given loop with the result of the task, i.e. completion(loop, result), or completion(loop) if the task doesn't return a value. If the task throws an exception, failure(loop, exception) is invoked on the given loop instead, so a completion or a failure is always delivered. The loop is never blocked waiting for the task. This function is thread-safe.
+			template <typename FunctionT, typename CompletionT, typename FailureT>
+			void submit (FunctionT task, Ref<Loop> loop, CompletionT completion, FailureT failure)
+			{
+				typedef decltype(std::declval<FunctionT &>()()) ResultT;
+
+				submit(Completion<ResultT>::wrap(std::move(task), loop, std::move(completion), std::move(failure)));
+			}
+
+			/// As above, but an exception thrown by the task is rethrown on the given loop.
+			template <typename FunctionT, typename CompletionT>
+			void submit (FunctionT task, Ref<Loop> loop, CompletionT completion)
+			{
+				submit(std::move(task), loop, std::move(completion), RethrowFailure());
+			}
+
+			/// Stop the workers once all submitted tasks have been run.
+			void stop ();
+
+			/// Counters which can be used for tuning the number of workers. This function is thread-safe.
+			Statistics statistics () const;
+		};
+
+		template <>
+		struct Executor::Completion<void> {
+			template <typename FunctionT, typename CompletionT, typename FailureT>
+			static Executor::TaskT wrap (FunctionT function, Ref<Loop> loop, CompletionT completion, FailureT failure)
+			{
+				return [function, loop, completion, failure]() mutable {
+					try {
+						function();
+
+						loop->post_urgent([completion](Loop * loop) mutable {
+							completion(loop);
+						});
+					} catch (...) {
+						fail(loop, failure, std::current_exception());
+					}
+				};
+			}
+		};
+	}
+}
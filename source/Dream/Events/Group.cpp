@@ -0,0 +1,146 @@
+//
+//  Group.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Group.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace Dream
+{
+	namespace Events
+	{
+		LoopGroup::LoopGroup (std::size_t count, BalanceStrategy strategy, MonitorType monitor_type) : _strategy(strategy), _next(0)
+		{
+			if (count == 0)
+				count = std::max(1u, std::thread::hardware_concurrency());
+
+			_assigned.reset(new std::atomic<std::size_t>[count]);
+
+			for (std::size_t i = 0; i < count; i += 1) {
+				_threads.push_back(new Thread(monitor_type));
+				_assigned[i] = 0;
+			}
+		}
+
+		LoopGroup::~LoopGroup ()
+		{
+			stop();
+		}
+
+		Ref<Loop> LoopGroup::loop (std::size_t index)
+		{
+			return _threads.at(index)->loop();
+		}
+
+		std::vector<Ref<Loop>> LoopGroup::loops ()
+		{
+			std::vector<Ref<Loop>> loops;
+
+			for (auto & thread : _threads)
+				loops.push_back(thread->loop());
+
+			return loops;
+		}
+
+		Ref<Thread> LoopGroup::thread (std::size_t index)
+		{
+			return _threads.at(index);
+		}
+
+		void LoopGroup::set_affinity (std::vector<unsigned> cpus)
+		{
+			if (cpus.empty()) {
+				unsigned count = std::max(1u, std::thread::hardware_concurrency());
+
+				for (unsigned cpu = 0; cpu < count; cpu += 1)
+					cpus.push_back(cpu);
+			}
+
+			for (std::size_t i = 0; i < _threads.size(); i += 1)
+				_threads[i]->set_affinity({cpus[i % cpus.size()]});
+		}
+
+		void LoopGroup::start ()
+		{
+			for (auto & thread : _threads)
+				thread->start();
+		}
+
+		void LoopGroup::stop ()
+		{
+			for (auto & thread : _threads)
+				thread->loop()->stop();
+
+			for (auto & thread : _threads)
+				thread->stop();
+		}
+
+		std::size_t LoopGroup::select ()
+		{
+			if (_strategy == LEAST_LOADED) {
+				std::size_t best = 0, best_load = std::numeric_limits<std::size_t>::max();
+
+				// Scanning is cheap compared to adding a source, even for a large number of loops:
+				for (std::size_t i = 0; i < _threads.size(); i += 1) {
+					std::size_t load = _threads[i]->loop()->load() + _assigned[i].load(std::memory_order_relaxed);
+
+					if (load < best_load) {
+						best = i;
+						best_load = load;
+					}
+				}
+
+				return best;
+			} else {
+				return _next.fetch_add(1, std::memory_order_relaxed) % _threads.size();
+			}
+		}
+
+		Ref<Loop> LoopGroup::next_loop ()
+		{
+			return _threads[select()]->loop();
+		}
+
+		Ref<Loop> LoopGroup::monitor (Ref<IFileDescriptorSource> source, int events)
+		{
+			std::size_t index = select();
+			std::atomic<std::size_t> * assigned = &_assigned[index];
+
+			Ref<Loop> loop = _threads[index]->loop();
+
+			assigned->fetch_add(1, std::memory_order_relaxed);
+
+			loop->post_urgent([source, events, assigned](Loop * loop) {
+				loop->monitor(source, events);
+
+				assigned->fetch_sub(1, std::memory_order_relaxed);
+			});
+
+			return loop;
+		}
+
+		Ref<Loop> LoopGroup::schedule_timer (Ref<ITimerSource> source)
+		{
+			std::size_t index = select();
+			std::atomic<std::size_t> * assigned = &_assigned[index];
+
+			Ref<Loop> loop = _threads[index]->loop();
+
+			assigned->fetch_add(1, std::memory_order_relaxed);
+
+			loop->post_urgent([source, assigned](Loop * loop) {
+				loop->schedule_timer(source);
+
+				assigned->fetch_sub(1, std::memory_order_relaxed);
+			});
+
+			return loop;
+		}
+	}
+}
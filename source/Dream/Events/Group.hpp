@@ -0,0 +1,91 @@
+//
+//  Group.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Thread.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Selects how a LoopGroup assigns new work to its loops.
+		enum BalanceStrategy {
+			/// Each loop is used in turn.
+			ROUND_ROBIN = 0,
+			/// The loop with the lowest Loop::load() is used, including work which has been assigned but not yet added by the loop.
+			LEAST_LOADED = 1
+		};
+
+		/// Manage a number of event-loops, each on a separate thread, and distribute file descriptors and timers between them.
+		class LoopGroup : public Object {
+		protected:
+			BalanceStrategy _strategy;
+
+			std::vector<Ref<Thread>> _threads;
+
+			// Work which has been assigned to each loop but not yet added to it:
+			std::unique_ptr<std::atomic<std::size_t>[]> _assigned;
+
+			std::atomic<std::size_t> _next;
+
+			std::size_t select ();
+
+		public:
+			/// If count is 0, one loop is created for each hardware thread.
+			LoopGroup (std::size_t count = 0, BalanceStrategy strategy = ROUND_ROBIN, MonitorType monitor_type = SYSTEM_MONITOR);
+
+			/// This destructor may block if any of the event-loops are not responding.
+			virtual ~LoopGroup ();
+
+			std::size_t size () const { return _threads.size(); }
+
+			Ref<Loop> loop (std::size_t index);
+
+			/// All loops, e.g. to create a ShardedAcceptor.
+			std::vector<Ref<Loop>> loops ();
+
+			/// The thread running the given loop, e.g. to configure it before the group is started.
+			Ref<Thread> thread (std::size_t index);
+
+			void set_strategy (BalanceStrategy strategy) { _strategy = strategy; }
+			BalanceStrategy strategy () const { return _strategy; }
+
+			/// Pin each loop to one CPU, assigning CPUs from the given list in turn, or CPU 0 to N-1 if the list is empty. For NUMA systems, list the CPUs of each node together so that neighbouring loops share a node. This must be called before the group is started.
+			void set_affinity (std::vector<unsigned> cpus = std::vector<unsigned>());
+
+			/// Start all event-loops.
+			void start ();
+
+			/// Stop all event-loops. Every loop is asked to stop before waiting for any of them, so that they shut down concurrently.
+			void stop ();
+
+			/// Select a loop according to the balance strategy. This function is thread-safe.
+			Ref<Loop> next_loop ();
+
+			/// Monitor a file descriptor on the next loop. The source is added by sending an urgent notification. This function is thread-safe.
+			/// @returns the loop which will monitor the source.
+			Ref<Loop> monitor (Ref<IFileDescriptorSource> source, int events);
+
+			/// Schedule a timer on the next loop. This function is thread-safe.
+			/// @returns the loop which will run the timer.
+			Ref<Loop> schedule_timer (Ref<ITimerSource> source);
+
+			/// Invoke a function with the signature void(Loop *) on every loop, on the thread of that loop. This function is thread-safe.
+			template <typename FunctionT>
+			void for_each_loop (const FunctionT & function)
+			{
+				for (auto & thread : _threads)
+					thread->loop()->post_urgent(function);
+			}
+		};
+	}
+}
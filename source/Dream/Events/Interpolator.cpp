@@ -8,12 +8,13 @@
 //
 
 #include "Interpolator.hpp"
+#include "Loop.hpp"
 
 namespace Dream
 {
 	namespace Events
 	{
-		Interpolator::Interpolator(int steps, TimeT increment) : _count(0), _steps(steps), _increment(increment), _finished(false)
+		Interpolator::Interpolator(int steps, TimeT increment) : _count(0), _steps(steps), _increment(increment), _finished(false), _loop(nullptr)
 		{
 		}
 
@@ -33,7 +34,23 @@ namespace Dream
 
 		void Interpolator::cancel ()
 		{
+			// As per TimerSource::cancel(), either the interpolator is removed here, or scheduled() sees that it was cancelled:
 			_finished = true;
+
+			Loop * loop = _loop;
+
+			if (loop == nullptr)
+				return;
+
+			if (loop->on_loop_thread()) {
+				loop->cancel_timer(_handle);
+			} else {
+				Ref<Interpolator> interpolator(this);
+
+				loop->post_urgent([interpolator](Loop *) {
+					interpolator->cancel();
+				});
+			}
 		}
 
 		bool Interpolator::repeats () const
@@ -48,9 +65,23 @@ namespace Dream
 			return last_timeout + _increment;
 		}
 
+		void Interpolator::scheduled (Loop * loop, const TimerHandle & handle)
+		{
+			if (loop) {
+				_loop = loop;
+				_handle = handle;
+
+				if (_finished)
+					loop->cancel_timer(handle);
+			} else if (handle == _handle) {
+				_loop = nullptr;
+			}
+		}
+
 		void Interpolator::process_events (Loop *, Event event)
 		{
-			if (event == TIMEOUT) {
+			// The interpolator may have been cancelled by a separate thread before it was removed:
+			if (event == TIMEOUT && !_finished) {
 				_count += 1;
 
 				TimeT time = TimeT(_count) / TimeT(_steps);
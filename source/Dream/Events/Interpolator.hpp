@@ -26,12 +26,17 @@ namespace Dream
 			int _count, _steps;
 			TimeT _increment;
 
-			bool _finished;
+			std::atomic<bool> _finished;
+
+			// The loop which the interpolator was most recently added to, while it is scheduled. The handle is only used on the loop thread:
+			std::atomic<Loop *> _loop;
+			TimerHandle _handle;
 
 		public:
 			Interpolator(int steps, TimeT increment);
 			virtual ~Interpolator ();
 
+			/// Stop the interpolator and remove it from the loop. This function is thread-safe: if called from a separate thread, the interpolator stops updating immediately, and it is removed by the loop thread.
 			void cancel ();
 			bool finished () { return _finished; }
 
@@ -40,6 +45,7 @@ namespace Dream
 
 			virtual bool repeats () const;
 			virtual TimeT next_timeout (const TimeT & last_timeout, const TimeT & current_time) const;
+			virtual void scheduled (Loop * loop, const TimerHandle & handle);
 			virtual void process_events (Loop *, Event);
 		};
 	}
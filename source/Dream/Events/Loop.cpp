@@ -16,12 +16,29 @@
 
 #include <iostream>
 #include <limits>
+#include <cmath>
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_map>
 #include <unistd.h>
 
 #if defined(TARGET_OS_LINUX)
 // PollMonitor
 	#include <poll.h>
+// EPollMonitor
+	#include <sys/epoll.h>
+// IOURingMonitor
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <linux/io_uring.h>
+
+	#if defined(__NR_io_uring_setup) && defined(IORING_ENTER_EXT_ARG)
+		#define DREAM_USE_IO_URING
+	#endif
 #elif defined(TARGET_OS_MAC)
 // KQueueMonitor
 	#include <sys/types.h>
@@ -37,6 +54,49 @@ namespace Dream
 	{
 		static const bool DEBUG = false;
 
+// MARK: -
+// MARK: struct Loop::Dispatch
+
+		struct Loop::Dispatch {
+			Loop * loop;
+			Ref<Trace> trace;
+
+			const std::type_info * source;
+			FileDescriptor file_descriptor;
+			int state;
+
+			Dispatch (Loop * loop_, const std::type_info & type, FileDescriptor file_descriptor_ = -1) : loop(loop_), trace(loop_->_trace)
+			{
+				LoopActivity & activity = loop->_activity;
+
+				activity.beat();
+
+				// Sources can run nested loops, so the previous activity is restored afterwards. Only the loop thread writes the activity, so it doesn't need atomic exchanges:
+				source = activity.source.load(std::memory_order_relaxed);
+				file_descriptor = activity.file_descriptor.load(std::memory_order_relaxed);
+				state = activity.state.load(std::memory_order_relaxed);
+
+				activity.source.store(&type, std::memory_order_relaxed);
+				activity.file_descriptor.store(file_descriptor_, std::memory_order_relaxed);
+				activity.state.store(LoopActivity::RUNNING, std::memory_order_relaxed);
+
+				if (trace)
+					trace->begin(type, file_descriptor_);
+			}
+
+			~Dispatch ()
+			{
+				if (trace)
+					trace->end();
+
+				LoopActivity & activity = loop->_activity;
+
+				activity.source.store(source, std::memory_order_relaxed);
+				activity.file_descriptor.store(file_descriptor, std::memory_order_relaxed);
+				activity.state.store(state, std::memory_order_relaxed);
+			}
+		};
+
 // MARK: -
 // MARK: Helper Functions
 
@@ -74,7 +134,6 @@ namespace Dream
 
 // MARK: File Descriptor Monitor Implementations
 // MARK: -
-		typedef std::set<Ref<IFileDescriptorSource>> FileDescriptorHandlesT;
 
 #if defined(TARGET_OS_MAC)
 		class KQueueMonitor : public Object, virtual public IMonitor {
@@ -82,15 +141,21 @@ namespace Dream
 			FileDescriptor _kqueue;
 			std::set<FileDescriptor> _removed_file_descriptors;
 
+			// The events each source is registered for.
+			typedef std::map<Ref<IFileDescriptorSource>, int> FileDescriptorHandlesT;
 			FileDescriptorHandlesT _file_descriptor_handles;
 
+			void update_filters (Ptr<IFileDescriptorSource> source, int current_events, int events);
+
 		public:
 			KQueueMonitor ();
 			virtual ~KQueueMonitor ();
 
-			virtual void add_source (Ptr<IFileDescriptorSource> source);
+			virtual void add_source (Ptr<IFileDescriptorSource> source, int events);
 			virtual void remove_source (Ptr<IFileDescriptorSource> source);
 
+			virtual void set_interest (Ptr<IFileDescriptorSource> source, int events);
+
 			virtual std::size_t source_count () const;
 
 			virtual std::size_t wait_for_events (TimeT timeout, Loop * loop);
@@ -106,24 +171,32 @@ namespace Dream
 			close(_kqueue);
 		}
 
-		void KQueueMonitor::add_source (Ptr<IFileDescriptorSource> source)
+		void KQueueMonitor::update_filters (Ptr<IFileDescriptorSource> source, int current_events, int events)
 		{
 			SystemError::reset();
 
 			FileDescriptor fd = source->file_descriptor();
-			_file_descriptor_handles.insert(source);
 
-			int mode = events_for_file_descriptor(fd);
+			int added = events & ~current_events;
+			int removed = current_events & ~events;
 
-			struct kevent change[2];
+			struct kevent change[4];
 			int c = 0;
 
-			if (mode & READ_READY)
+			if (added & READ_READY)
 				EV_SET(&change[c++], fd, EVFILT_READ, EV_ADD, 0, 0, (void*)source.get());
 
-			if (mode & WRITE_READY)
+			if (added & WRITE_READY)
 				EV_SET(&change[c++], fd, EVFILT_WRITE, EV_ADD, 0, 0, (void*)source.get());
 
+			if (removed & READ_READY)
+				EV_SET(&change[c++], fd, EVFILT_READ, EV_DELETE, 0, 0, 0);
+
+			if (removed & WRITE_READY)
+				EV_SET(&change[c++], fd, EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+
+			if (c == 0) return;
+
 			int result = kevent(_kqueue, change, c, NULL, 0, NULL);
 
 			if (result == -1) {
@@ -131,36 +204,41 @@ namespace Dream
 			}
 		}
 
-		std::size_t KQueueMonitor::source_count () const
+		void KQueueMonitor::add_source (Ptr<IFileDescriptorSource> source, int events)
 		{
-			return _file_descriptor_handles.size();
+			_file_descriptor_handles[source] = events;
+
+			update_filters(source, 0, events);
 		}
 
-		void KQueueMonitor::remove_source (Ptr<IFileDescriptorSource> source)
+		void KQueueMonitor::set_interest (Ptr<IFileDescriptorSource> source, int events)
 		{
-			SystemError::reset();
+			FileDescriptorHandlesT::iterator handle = _file_descriptor_handles.find(source);
 
-			FileDescriptor fd = source->file_descriptor();
+			if (handle == _file_descriptor_handles.end() || handle->second == events)
+				return;
 
-			struct kevent change[2];
-			int c = 0;
+			update_filters(source, handle->second, events);
 
-			int mode = events_for_file_descriptor(fd);
+			handle->second = events;
+		}
 
-			if (mode & READ_READY)
-				EV_SET(&change[c++], fd, EVFILT_READ, EV_DELETE, 0, 0, 0);
+		std::size_t KQueueMonitor::source_count () const
+		{
+			return _file_descriptor_handles.size();
+		}
 
-			if (mode & WRITE_READY)
-				EV_SET(&change[c++], fd, EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+		void KQueueMonitor::remove_source (Ptr<IFileDescriptorSource> source)
+		{
+			FileDescriptorHandlesT::iterator handle = _file_descriptor_handles.find(source);
 
-			int result = kevent(_kqueue, change, c, NULL, 0, NULL);
+			if (handle == _file_descriptor_handles.end())
+				return;
 
-			if (result == -1) {
-				SystemError::check("kevent");
-			}
+			update_filters(source, handle->second, 0);
 
-			_removed_file_descriptors.insert(fd);
-			_file_descriptor_handles.erase(source);
+			_removed_file_descriptors.insert(source->file_descriptor());
+			_file_descriptor_handles.erase(handle);
 		}
 
 		std::size_t KQueueMonitor::wait_for_events (TimeT timeout, Loop * loop)
@@ -183,11 +261,16 @@ namespace Dream
 				kevent_timeout.tv_nsec = 0;
 			}
 
+			TimeT started = loop->stopwatch().time();
+
 			if (timeout < 0)
 				count = kevent(_kqueue, NULL, 0, events, KQUEUE_SIZE, NULL);
 			else
 				count = kevent(_kqueue, NULL, 0, events, KQUEUE_SIZE, &kevent_timeout);
 
+			if (timeout != 0)
+				loop->blocked(loop->stopwatch().time() - started);
+
 			if (count == -1) {
 				SystemError::check("kevent");
 			} else {
@@ -205,6 +288,8 @@ namespace Dream
 					}
 
 					try {
+						Loop::Dispatch dispatch(loop, typeid(*s), s->file_descriptor());
+
 						if (events[i].filter == EVFILT_READ)
 							s->process_events(loop, READ_READY);
 
@@ -232,25 +317,47 @@ namespace Dream
 #if defined(TARGET_OS_LINUX)
 		class PollMonitor : public Object, virtual public IMonitor {
 		protected:
-			// Used to provide O(1) delete time within process_events handler
-			bool _delete_current_file_descriptor_handle;
-			Ref<IFileDescriptorSource> _current_file_descriptor_source;
+			// The pollfd array is kept between calls and updated in place, so that adding, removing and changing the interest of a source is O(1).
+			std::vector<struct pollfd> _pollfds;
+			std::vector<Ref<IFileDescriptorSource>> _sources;
+			std::unordered_map<IFileDescriptorSource *, std::size_t> _indices;
 
-			FileDescriptorHandlesT _file_descriptor_handles;
+			// Sources removed while events are being dispatched are disabled, and erased once dispatching has finished.
+			bool _dispatching;
+			std::vector<std::size_t> _removed_indices;
+
+			void erase (std::size_t index);
 
 		public:
 			PollMonitor ();
 			virtual ~PollMonitor ();
 
-			virtual void add_source (Ptr<IFileDescriptorSource> source);
+			virtual void add_source (Ptr<IFileDescriptorSource> source, int events);
 			virtual void remove_source (Ptr<IFileDescriptorSource> source);
 
+			virtual void set_interest (Ptr<IFileDescriptorSource> source, int events);
+
 			virtual std::size_t source_count () const;
 
 			virtual std::size_t wait_for_events (TimeT timeout, Loop * loop);
 		};
 
-		PollMonitor::PollMonitor ()
+		static void set_poll_events (struct pollfd & pfd, FileDescriptor fd, int events)
+		{
+			pfd.events = 0;
+			pfd.revents = 0;
+
+			if (events & READ_READY)
+				pfd.events |= POLLIN;
+
+			if (events & WRITE_READY)
+				pfd.events |= POLLOUT;
+
+			// A negative file descriptor is ignored by poll, otherwise hangups and errors would still be reported:
+			pfd.fd = pfd.events ? fd : -1;
+		}
+
+		PollMonitor::PollMonitor () : _dispatching(false)
 		{
 		}
 
@@ -258,23 +365,73 @@ namespace Dream
 		{
 		}
 
-		void PollMonitor::add_source (Ptr<IFileDescriptorSource> source)
+		void PollMonitor::add_source (Ptr<IFileDescriptorSource> source, int events)
+		{
+			if (_indices.find(source.get()) != _indices.end())
+				return;
+
+			struct pollfd pfd;
+			set_poll_events(pfd, source->file_descriptor(), events);
+
+			_indices[source.get()] = _pollfds.size();
+			_pollfds.push_back(pfd);
+			_sources.push_back(source);
+		}
+
+		void PollMonitor::erase (std::size_t index)
 		{
-			_file_descriptor_handles.insert(source);
+			std::size_t last = _pollfds.size() - 1;
+
+			if (index != last) {
+				_pollfds[index] = _pollfds[last];
+				_sources[index] = _sources[last];
+
+				_indices[_sources[index].get()] = index;
+			}
+
+			_pollfds.pop_back();
+			_sources.pop_back();
 		}
 
 		void PollMonitor::remove_source (Ptr<IFileDescriptorSource> source)
 		{
-			if (_current_file_descriptor_source == source) {
-				_delete_current_file_descriptor_handle = true;
+			auto iterator = _indices.find(source.get());
+
+			if (iterator == _indices.end())
+				return;
+
+			std::size_t index = iterator->second;
+			_indices.erase(iterator);
+
+			if (_dispatching) {
+				// Disable the entry so that it doesn't receive any further events:
+				_pollfds[index].fd = -1;
+				_pollfds[index].revents = 0;
+
+				_removed_indices.push_back(index);
 			} else {
-				_file_descriptor_handles.erase(source);
+				erase(index);
+			}
+		}
+
+		void PollMonitor::set_interest (Ptr<IFileDescriptorSource> source, int events)
+		{
+			auto iterator = _indices.find(source.get());
+
+			if (iterator != _indices.end()) {
+				struct pollfd & pfd = _pollfds[iterator->second];
+				short revents = pfd.revents;
+
+				set_poll_events(pfd, source->file_descriptor(), events);
+
+				// Events which have been received but not yet dispatched are filtered by the new interest:
+				pfd.revents = revents & (pfd.events|POLLHUP|POLLERR|POLLNVAL);
 			}
 		}
 
 		std::size_t PollMonitor::source_count () const
 		{
-			return _file_descriptor_handles.size();
+			return _indices.size();
 		}
 
 		std::size_t PollMonitor::wait_for_events (TimeT timeout, Loop * loop)
@@ -284,25 +441,8 @@ namespace Dream
 			// Number of events which have been processed
 			int count = 0;
 
-			std::vector<FileDescriptorHandlesT::iterator> handles;
-			std::vector<struct pollfd> pollfds;
-
-			handles.reserve(_file_descriptor_handles.size());
-			pollfds.reserve(_file_descriptor_handles.size());
-
-			for (FileDescriptorHandlesT::iterator i = _file_descriptor_handles.begin(); i != _file_descriptor_handles.end(); i++) {
-				struct pollfd pfd;
-
-				pfd.fd = (*i)->file_descriptor();
-				pfd.events = POLLIN|POLLOUT;
-
-				handles.push_back(i);
-				pollfds.push_back(pfd);
-
-				//std::cerr << "Monitoring " << (*i)->class_name() << " fd: " << (*i)->file_descriptor() << std::endl;
-			}
-
 			int result = 0;
+			TimeT started = loop->stopwatch().time();
 
 			if (timeout > 0.0) {
 				// Convert timeout to milliseconds
@@ -310,327 +450,1790 @@ namespace Dream
 				// Granularity of poll is not very good, so it might run through the loop multiple times
 				// in order to reach a timeout. When timeout is less than 1ms, timeout * 1000 = 0, i.e.
 				// non-blocking poll.
-				result = poll(&pollfds[0], pollfds.size(), (timeout * 1000) + 1);
+				result = poll(_pollfds.data(), _pollfds.size(), (timeout * 1000) + 1);
 			} else if (timeout == 0) {
-				result = poll(&pollfds[0], pollfds.size(), 0);
+				result = poll(_pollfds.data(), _pollfds.size(), 0);
 			} else {
-				result = poll(&pollfds[0], pollfds.size(), -1);
+				result = poll(_pollfds.data(), _pollfds.size(), -1);
 			}
 
+			if (timeout != 0)
+				loop->blocked(loop->stopwatch().time() - started);
+
 			if (result < 0) {
+				// A signal interrupting the wait is not an error:
+				if (errno == EINTR)
+					return 0;
+
 				SystemError::check("poll");
 			}
 
-			_delete_current_file_descriptor_handle = false;
-
 			if (result > 0) {
-				for (unsigned i = 0; i < pollfds.size(); i += 1) {
+				_dispatching = true;
+
+				// Sources added while dispatching are appended and will be polled next time:
+				std::size_t size = _pollfds.size();
+
+				for (std::size_t i = 0; i < size; i += 1) {
+					short revents = _pollfds[i].revents;
+
+					if (revents == 0) continue;
+
+					_pollfds[i].revents = 0;
+
+					Ref<IFileDescriptorSource> source = _sources[i];
+
+					if (revents & POLLNVAL) {
+						log_error("Invalid file descriptor:", source->file_descriptor());
+					}
+
 					int e = 0;
 
-					if (pollfds[i].revents & POLLIN)
+					if (revents & POLLIN)
 						e |= READ_READY;
 
-					if (pollfds[i].revents & POLLOUT)
+					if (revents & POLLOUT)
 						e |= WRITE_READY;
 
-					if (pollfds[i].revents & POLLNVAL) {
-						log_error("Invalid file descriptor:", pollfds[i].fd);
+					// Hangups and errors are reported as whatever the source is interested in, so that it observes them when it reads or writes:
+					if (revents & (POLLHUP|POLLERR)) {
+						if (_pollfds[i].events & POLLIN)
+							e |= READ_READY;
+
+						if (_pollfds[i].events & POLLOUT)
+							e |= WRITE_READY;
 					}
 
 					if (e == 0) continue;
 
 					count += 1;
-					_current_file_descriptor_source = *(handles[i]);
 
 					try {
-						_current_file_descriptor_source->process_events(loop, Event(e));
+						Loop::Dispatch dispatch(loop, typeid(*source), source->file_descriptor());
+						source->process_events(loop, Event(e));
 					} catch (FileDescriptorClosed & ex) {
-						_delete_current_file_descriptor_handle = true;
+						remove_source(source);
 					} catch (std::runtime_error & ex) {
 						log_error("Exception thrown by runloop:", ex.what());
-						log_error("Removing file descriptor:", _current_file_descriptor_source->file_descriptor());
+						log_error("Removing file descriptor:", source->file_descriptor());
 
-						_delete_current_file_descriptor_handle = true;
-					}
-
-					if (_delete_current_file_descriptor_handle) {
-						// O(1) delete time if deleting current handle
-						_file_descriptor_handles.erase(handles[i]);
-						_delete_current_file_descriptor_handle = false;
+						remove_source(source);
 					}
 				}
+
+				_dispatching = false;
+
+				// Erase from the highest index first, so that the entries moved into their place have already been checked:
+				std::sort(_removed_indices.begin(), _removed_indices.end(), std::greater<std::size_t>());
+
+				for (auto index : _removed_indices)
+					erase(index);
+
+				_removed_indices.clear();
 			}
 
 			return count;
 		}
 
-		typedef PollMonitor SystemMonitor;
-#endif
-
 // MARK: -
-// MARK: class Loop
-
-		Loop::Loop () : _stop_when_idle(true), _rate_limit(20)
-		{
-			// Setup file descriptor monitor
-			_monitor = new SystemMonitor;
 
-			// Setup timers
-			_stopwatch.start();
+		class EPollMonitor : public Object, virtual public IMonitor {
+		protected:
+			struct Registration {
+				Ref<IFileDescriptorSource> source;
 
-			// Create and open an urgent notification pipe
-			_urgent_notification_pipe = new NotificationPipeSource;
-			monitor(_urgent_notification_pipe);
-		}
+				// The events the source is interested in, and the events registered with the kernel.
+				int events, registered_events;
 
-		Loop::~Loop ()
-		{
-			// Remove the internal urgent notification pipe
-			//std::cerr << "Stop monitoring urgent notification pipe..." << std::endl;
-			//stop_monitoring_file_descriptor(_urgent_notification_pipe);
+				bool changed, removed;
+			};
 
-			//foreach(Ref<IFileDescriptorSource> source, _file_descriptor_handles)
-			//{
-			//	std::cerr << "FD Still Scheduled: " << source->class_name() << source->file_descriptor() << std::endl;
-			//}
-		}
+			FileDescriptor _epoll;
 
-		void Loop::set_stop_when_idle (bool stop_when_idle)
-		{
-			_stop_when_idle = stop_when_idle;
-		}
+			std::unordered_map<IFileDescriptorSource *, Registration *> _registrations;
 
-		const Stopwatch & Loop::stopwatch () const
-		{
-			return _stopwatch;
-		}
+			// Changes of interest are applied just before the next wait, so toggling interest within one iteration doesn't need any system calls.
+			std::vector<Registration *> _changes;
 
-// MARK: -
+			// Registrations removed while events are being dispatched or while they have pending changes are deleted at the end of wait_for_events, as they may still be referred to.
+			bool _dispatching;
+			std::vector<Registration *> _removed;
 
-		/// Used to schedule a timer to the loop via a notification.
-		class ScheduleTimerNotificationSource : public Object, virtual public INotificationSource {
-		protected:
-			Ref<ITimerSource> _timer_source;
+			void update (Registration * registration);
+			void apply_changes ();
 
 		public:
-			ScheduleTimerNotificationSource(Ref<ITimerSource> timer_source);
-			virtual ~ScheduleTimerNotificationSource ();
+			EPollMonitor ();
+			virtual ~EPollMonitor ();
+
+			virtual void add_source (Ptr<IFileDescriptorSource> source, int events);
+			virtual void remove_source (Ptr<IFileDescriptorSource> source);
 
-			virtual void process_events (Loop * event_loop, Event event);
+			virtual void set_interest (Ptr<IFileDescriptorSource> source, int events);
+
+			virtual std::size_t source_count () const;
+
+			virtual std::size_t wait_for_events (TimeT timeout, Loop * loop);
 		};
 
-		ScheduleTimerNotificationSource::ScheduleTimerNotificationSource(Ref<ITimerSource> timer_source) : _timer_source(timer_source)
+		EPollMonitor::EPollMonitor () : _dispatching(false)
 		{
-		}
+			SystemError::reset();
 
-		ScheduleTimerNotificationSource::~ScheduleTimerNotificationSource ()
-		{
+			_epoll = epoll_create1(EPOLL_CLOEXEC);
+
+			if (_epoll == -1) {
+				SystemError::check("epoll_create1");
+			}
 		}
 
-		void ScheduleTimerNotificationSource::process_events (Loop * event_loop, Event event)
+		EPollMonitor::~EPollMonitor ()
 		{
-			// Add the timer into the run-loop.
-			if (event == NOTIFICATION)
-				event_loop->schedule_timer(_timer_source);
+			close(_epoll);
+
+			for (auto & registration : _registrations)
+				delete registration.second;
+
+			for (auto registration : _removed)
+				delete registration;
 		}
 
-		void Loop::schedule_timer (Ref<ITimerSource> source)
+		void EPollMonitor::update (Registration * registration)
 		{
-			if (std::this_thread::get_id() == _current_thread) {
-				TimerHandle th;
+			SystemError::reset();
 
-				TimeT current_time = _stopwatch.time();
-				th.timeout = source->next_timeout(current_time, current_time);
+			struct epoll_event event = {};
+			event.data.ptr = (void*)registration;
 
-				th.source = source;
+			if (registration->events & READ_READY)
+				event.events |= EPOLLIN;
 
-				_timer_handles.push(th);
-			} else {
-				if (DEBUG) log_debug("Posting notification to remote event loop");
+			if (registration->events & WRITE_READY)
+				event.events |= EPOLLOUT;
 
-				// Add the timer via a notification which is passed across the thread.
-				Ref<ScheduleTimerNotificationSource> note = new ScheduleTimerNotificationSource(source);
+			int operation = EPOLL_CTL_MOD;
 
-				// If the event loop is currently running forever with a timeout of -1, the notification will never be processed unless it is set to urgent. It might be better to have a default timeout for the runloop and expose this behaviour to the client library rather than just posting all schedule timer notifcations as urgent.
-				this->post_notification(note, true);
+			// A file descriptor with no interest is removed from the epoll set, otherwise hangups and errors would still be reported:
+			if (registration->registered_events == 0)
+				operation = EPOLL_CTL_ADD;
+			else if (registration->events == 0)
+				operation = EPOLL_CTL_DEL;
+
+			int result = epoll_ctl(_epoll, operation, registration->source->file_descriptor(), &event);
+
+			if (result == -1) {
+				SystemError::check("epoll_ctl");
 			}
-		}
 
-// MARK: -
+			registration->registered_events = registration->events;
+		}
 
-		void Loop::post_notification (Ref<INotificationSource> note, bool urgent)
+		void EPollMonitor::apply_changes ()
 		{
-			// Lock the event loop notification queue
-			// Add note to the end of the queue
-			// Interrupt event loop thread if urgent
-
-			if (std::this_thread::get_id() == _current_thread) {
-				note->process_events(this, NOTIFICATION);
-			} else {
-				{
-					// Enqueue the notification to be processed
-					std::lock_guard<std::mutex> lock(_notifications.lock);
-					_notifications.sources.push(note);
-				}
+			for (auto registration : _changes) {
+				registration->changed = false;
 
-				if (urgent) {
-					// Interrupt event loop thread so that it processes notifications more quickly
-					_urgent_notification_pipe->notify_event_loop();
-				}
+				if (!registration->removed && registration->events != registration->registered_events)
+					update(registration);
 			}
+
+			_changes.clear();
 		}
 
-		void Loop::monitor (Ptr<IFileDescriptorSource> source)
+		void EPollMonitor::add_source (Ptr<IFileDescriptorSource> source, int events)
 		{
-			DREAM_ASSERT(source->file_descriptor() != -1);
-			//std::cerr << this << " monitoring fd: " << fd << std::endl;
-			//IFileDescriptorSource::debug_file_descriptor_flags(fd);
+			if (_registrations.find(source.get()) != _registrations.end())
+				return;
 
-			_monitor->add_source(source);
+			Registration * registration = new Registration;
+			registration->source = source;
+			registration->events = events;
+			registration->registered_events = 0;
+			registration->changed = registration->removed = false;
+
+			if (events) {
+				try {
+					update(registration);
+				} catch (...) {
+					delete registration;
+					throw;
+				}
+			}
+
+			_registrations[source.get()] = registration;
 		}
 
-		void Loop::stop_monitoring_file_descriptor (Ptr<IFileDescriptorSource> source)
+		void EPollMonitor::remove_source (Ptr<IFileDescriptorSource> source)
 		{
-			DREAM_ASSERT(source->file_descriptor() != -1);
+			auto iterator = _registrations.find(source.get());
 
-			if (DEBUG) log_debug("Event loop removing file descriptor:", source->file_descriptor());
+			if (iterator == _registrations.end())
+				return;
 
-			//IFileDescriptorSource::debug_file_descriptor_flags(fd);
+			Registration * registration = iterator->second;
+			_registrations.erase(iterator);
 
-			_monitor->remove_source(source);
-		}
+			// If the file descriptor has already been closed, the kernel has removed it from the epoll set and this will fail, which is fine.
+			if (registration->registered_events)
+				epoll_ctl(_epoll, EPOLL_CTL_DEL, source->file_descriptor(), NULL);
 
-		/// If there is a timeout, returns true and the timeout in `at_time`.
-		/// If there isn't a timeout, returns false and -1 in `at_time`.
-		bool Loop::next_timeout (TimeT & at_time)
-		{
-			if (_timer_handles.empty()) {
-				at_time = -1;
-				return false;
-			} else {
-				at_time = _timer_handles.top().timeout - _stopwatch.time();
-				return true;
-			}
+			registration->removed = true;
+
+			if (_dispatching || registration->changed)
+				_removed.push_back(registration);
+			else
+				delete registration;
 		}
 
-		void Loop::stop ()
+		void EPollMonitor::set_interest (Ptr<IFileDescriptorSource> source, int events)
 		{
-			if (std::this_thread::get_id() != _current_thread) {
-				post_notification(NotificationSource::stop_loop_notification(), true);
-			} else {
-				_running = false;
+			auto iterator = _registrations.find(source.get());
+
+			if (iterator == _registrations.end())
+				return;
+
+			Registration * registration = iterator->second;
+			registration->events = events;
+
+			if (!registration->changed) {
+				registration->changed = true;
+				_changes.push_back(registration);
 			}
 		}
 
-		Loop::Notifications::Notifications ()
+		std::size_t EPollMonitor::source_count () const
 		{
+			return _registrations.size();
 		}
 
-		void Loop::Notifications::swap ()
+		std::size_t EPollMonitor::wait_for_events (TimeT timeout, Loop * loop)
 		{
-			// This function assumes that the structure has been locked..
-			std::swap(sources, processing);
-		}
+			apply_changes();
 
-		void Loop::process_notifications ()
-		{
-			// Escape quickly - if this is not thread-safe, we still shouldn't have a problem unless
-			// the data-structure itself gets corrupt, but this shouldn't be possible because empty() is const.
-			// If we get a false positive, we still check below by locking the structure properly.
-			if (_notifications.sources.empty())
-				return;
+			SystemError::reset();
 
-			{
-				std::lock_guard<std::mutex> lock(_notifications.lock);
+			const unsigned EPOLL_SIZE = 64;
+			struct epoll_event events[EPOLL_SIZE];
 
-				// Grab all pending notifications
-				_notifications.swap();
-			}
+			int result = 0;
+			TimeT started = loop->stopwatch().time();
 
-			if (DEBUG) log_debug("Processing", _notifications.processing.size(), "notifications");
+			if (timeout > 0.0) {
+				// Round up to the next millisecond so that we don't return before the timeout has expired:
+				timeout = std::min(timeout, (TimeT)(std::numeric_limits<int>::max() / 1000));
+				result = epoll_wait(_epoll, events, EPOLL_SIZE, std::ceil(timeout * 1000));
+			} else if (timeout == 0) {
+				result = epoll_wait(_epoll, events, EPOLL_SIZE, 0);
+			} else {
+				result = epoll_wait(_epoll, events, EPOLL_SIZE, -1);
+			}
 
-			unsigned rate = _rate_limit;
+			if (timeout != 0)
+				loop->blocked(loop->stopwatch().time() - started);
 
-			while (!_notifications.processing.empty() && (rate-- || _rate_limit == 0)) {
-				Ref<INotificationSource> note = _notifications.processing.front();
-				_notifications.processing.pop();
+			if (result < 0) {
+				// A signal interrupting the wait is not an error:
+				if (errno == EINTR)
+					return 0;
 
-				note->process_events(this, NOTIFICATION);
+				SystemError::check("epoll_wait");
 			}
 
-			if (rate == 0 && _rate_limit != 0) {
-				log_warning("Rate limiting notifications!");
-				log("Rescheduling", _notifications.processing.size(), "notifications.");
-				
-				while (!_notifications.processing.empty()) {
-					Ref<INotificationSource> note = _notifications.processing.front();
-					_notifications.processing.pop();
+			std::size_t count = 0;
 
-					post_notification(note, false);
-				}
-			}
-		}
+			_dispatching = true;
 
-		TimeT Loop::process_timers()
-		{
-			TimeT timeout = -1;
-			unsigned rate = _rate_limit;
+			for (int i = 0; i < result; i += 1) {
+				Registration * registration = (Registration *)events[i].data.ptr;
 
-			// next_timeout returns true if the timeout should be processed, and updates timeout with the time it was due
-			while (next_timeout(timeout)) {
-				if (DEBUG) log_debug("Timeout at:", timeout);
+				// Discard events for sources which were removed by an earlier event in this batch:
+				if (registration->removed)
+					continue;
 
-				if (timeout > 0.0) {
-					// The timeout was in the future:
-					break;
-				}
+				int e = 0;
 
-				if (_rate_limit > 0) {
-					// Are we rate-limiting timeouts?
-					rate -= 1;
+				if (events[i].events & EPOLLIN)
+					e |= READ_READY;
 
-					if (rate == 0) {
-						if (DEBUG) log_warning("Timers have been rate limited!");
+				if (events[i].events & EPOLLOUT)
+					e |= WRITE_READY;
 
-						// The timeout was rate limited, the timer needs to be called again on the next iteration of the event loop:
-						return 0.0;
-					}
-				}
+				// Hangups and errors are reported as whatever the source is interested in, so that it observes them when it reads or writes:
+				if (events[i].events & (EPOLLHUP|EPOLLERR))
+					e |= registration->events;
 
-				// Check if the timeout is late:
-				if (timeout < -0.1 && DEBUG)
-					log_warning("Timeout was late:", timeout);
+				// The interest may have been changed by an earlier event in this batch:
+				e &= registration->events;
+
+				if (e == 0) continue;
+
+				count += 1;
 
-				TimerHandle th = _timer_handles.top();
-				_timer_handles.pop();
+				Ref<IFileDescriptorSource> source = registration->source;
 
-				th.source->process_events(this, TIMEOUT);
+				try {
+					Loop::Dispatch dispatch(loop, typeid(*source), source->file_descriptor());
+					source->process_events(loop, Event(e));
+				} catch (FileDescriptorClosed & ex) {
+					remove_source(source);
+				} catch (std::runtime_error & ex) {
+					log_error("Exception thrown by runloop:", ex.what());
+					log_error("Removing file descriptor:", source->file_descriptor());
 
-				if (th.source->repeats()) {
-					// Calculate the next time to schedule.
-					th.timeout = th.source->next_timeout(th.timeout, _stopwatch.time());
-					_timer_handles.push(th);
+					remove_source(source);
 				}
 			}
 
-			if (DEBUG) log_debug("process_timers finished with timeout:", timeout);
+			_dispatching = false;
 
-			return timeout;
-		}
+			// Removed registrations may still be in the list of changes, so apply them before deleting:
+			apply_changes();
 
-		void Loop::process_file_descriptors (TimeT timeout)
-		{
-			if (DEBUG) log_debug("process_file_descriptors timeout:", timeout);
+			for (auto registration : _removed)
+				delete registration;
 
-			// Timeout is now the amount of time we have to process other events until another timeout will need to fire.
-			if (_monitor->source_count())
-				_monitor->wait_for_events(timeout, this);
-			else if (timeout > 0.0)
-				Core::sleep(timeout);
+			_removed.clear();
+
+			return count;
 		}
 
-		void Loop::run_one_iteration (bool use_timer_timeout, TimeT timeout)
-		{
+		typedef EPollMonitor SystemMonitor;
+#endif
+
+// MARK: -
+
+#if defined(DREAM_USE_IO_URING)
+		/// Waits for file descriptor readiness using io_uring. Poll requests for all sources are queued into the submission ring and submitted together with the wait in a single io_uring_enter per iteration, and the timeout is passed to the kernel with nanosecond precision.
+		/// Multishot poll requests are edge triggered, but sources expect level triggered events (e.g. a source may read only part of the available data). Instead, a one-shot poll is re-armed for each dispatched source, and the re-arm is submitted as part of the next wait so that it doesn't cost an additional system call.
+		class IOURingMonitor : public Object, virtual public IMonitor {
+		protected:
+			struct Registration {
+				Ref<IFileDescriptorSource> source;
+				int events;
+
+				// A poll request for this registration has been queued and has not completed yet.
+				bool armed;
+				// The source is not interested in any events, so it isn't polled.
+				bool idle;
+				bool removed;
+			};
+
+			FileDescriptor _ring;
+
+			void * _submission_ring;
+			std::size_t _submission_ring_size;
+			void * _completion_ring;
+			std::size_t _completion_ring_size;
+			struct io_uring_sqe * _submissions;
+			std::size_t _submissions_size;
+
+			unsigned * _submission_head, * _submission_tail, * _submission_mask, * _submission_array;
+			unsigned * _completion_head, * _completion_tail, * _completion_mask;
+			struct io_uring_cqe * _completions;
+
+			unsigned _submission_entries;
+			unsigned _pending_submissions;
+
+			std::unordered_map<IFileDescriptorSource *, Registration *> _registrations;
+
+			// Removed registrations which still have a poll request in flight.
+			std::set<Registration *> _retired;
+
+			// Registrations which were dispatched and need to be polled again.
+			std::vector<Registration *> _rearm;
+
+			// Completions which were reaped by wait_for_events, which is kept so that its capacity is reused.
+			std::vector<std::pair<Registration *, int>> _ready;
+
+			void close_ring ();
+
+			int enter (unsigned to_submit, unsigned min_complete, unsigned flags, void * argument = NULL, std::size_t argument_size = 0);
+
+			struct io_uring_sqe * next_submission ();
+			void flush_submissions ();
+
+			void submit_poll (Registration * registration);
+			void submit_poll_update (Registration * registration);
+			void submit_poll_remove (Registration * registration);
+
+			void retire (Registration * registration);
+
+		public:
+			IOURingMonitor ();
+			virtual ~IOURingMonitor ();
+
+			virtual void add_source (Ptr<IFileDescriptorSource> source, int events);
+			virtual void remove_source (Ptr<IFileDescriptorSource> source);
+
+			virtual void set_interest (Ptr<IFileDescriptorSource> source, int events);
+
+			virtual std::size_t source_count () const;
+
+			virtual std::size_t wait_for_events (TimeT timeout, Loop * loop);
+		};
+
+		IOURingMonitor::IOURingMonitor () : _ring(-1), _submission_ring(MAP_FAILED), _completion_ring(MAP_FAILED), _submissions((struct io_uring_sqe *)MAP_FAILED), _pending_submissions(0)
+		{
+			const unsigned ENTRIES = 256;
+
+			SystemError::reset();
+
+			struct io_uring_params params = {};
+
+			_ring = syscall(__NR_io_uring_setup, ENTRIES, &params);
+
+			if (_ring == -1) {
+				SystemError::check("io_uring_setup");
+			}
+
+			// We require the timeout to be supplied directly to io_uring_enter.
+			if (!(params.features & IORING_FEAT_EXT_ARG)) {
+				close_ring();
+				throw std::runtime_error("io_uring does not support IORING_FEAT_EXT_ARG");
+			}
+
+			_submission_entries = params.sq_entries;
+
+			_submission_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			_completion_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				_submission_ring_size = _completion_ring_size = std::max(_submission_ring_size, _completion_ring_size);
+			}
+
+			_submission_ring = mmap(NULL, _submission_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				_completion_ring = _submission_ring;
+			} else if (_submission_ring != MAP_FAILED) {
+				_completion_ring = mmap(NULL, _completion_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+			}
+
+			_submissions_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+			if (_completion_ring != MAP_FAILED) {
+				_submissions = (struct io_uring_sqe *)mmap(NULL, _submissions_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, _ring, IORING_OFF_SQES);
+			}
+
+			if (_submissions == MAP_FAILED) {
+				int error = errno;
+
+				close_ring();
+
+				errno = error;
+				SystemError::check("mmap");
+			}
+
+			char * submission_ring = (char *)_submission_ring;
+			_submission_head = (unsigned *)(submission_ring + params.sq_off.head);
+			_submission_tail = (unsigned *)(submission_ring + params.sq_off.tail);
+			_submission_mask = (unsigned *)(submission_ring + params.sq_off.ring_mask);
+			_submission_array = (unsigned *)(submission_ring + params.sq_off.array);
+
+			char * completion_ring = (char *)_completion_ring;
+			_completion_head = (unsigned *)(completion_ring + params.cq_off.head);
+			_completion_tail = (unsigned *)(completion_ring + params.cq_off.tail);
+			_completion_mask = (unsigned *)(completion_ring + params.cq_off.ring_mask);
+			_completions = (struct io_uring_cqe *)(completion_ring + params.cq_off.cqes);
+		}
+
+		IOURingMonitor::~IOURingMonitor ()
+		{
+			close_ring();
+
+			for (auto & registration : _registrations)
+				delete registration.second;
+
+			for (auto registration : _retired)
+				delete registration;
+
+			_registrations.clear();
+			_retired.clear();
+		}
+
+		void IOURingMonitor::close_ring ()
+		{
+			if (_submissions != MAP_FAILED)
+				munmap(_submissions, _submissions_size);
+
+			if (_completion_ring != MAP_FAILED && _completion_ring != _submission_ring)
+				munmap(_completion_ring, _completion_ring_size);
+
+			if (_submission_ring != MAP_FAILED)
+				munmap(_submission_ring, _submission_ring_size);
+
+			if (_ring != -1)
+				close(_ring);
+
+			_submissions = (struct io_uring_sqe *)MAP_FAILED;
+			_completion_ring = _submission_ring = MAP_FAILED;
+			_ring = -1;
+		}
+
+		int IOURingMonitor::enter (unsigned to_submit, unsigned min_complete, unsigned flags, void * argument, std::size_t argument_size)
+		{
+			return syscall(__NR_io_uring_enter, _ring, to_submit, min_complete, flags, argument, argument_size);
+		}
+
+		struct io_uring_sqe * IOURingMonitor::next_submission ()
+		{
+			unsigned head = __atomic_load_n(_submission_head, __ATOMIC_ACQUIRE);
+			unsigned tail = *_submission_tail + _pending_submissions;
+
+			if (tail - head >= _submission_entries) {
+				// The submission ring is full, so we need to submit what we have now:
+				flush_submissions();
+
+				SystemError::reset();
+
+				if (enter(_pending_submissions, 0, 0) < 0) {
+					SystemError::check("io_uring_enter");
+				}
+
+				_pending_submissions = 0;
+				tail = *_submission_tail;
+			}
+
+			unsigned index = tail & *_submission_mask;
+			struct io_uring_sqe * submission = &_submissions[index];
+
+			memset(submission, 0, sizeof(*submission));
+			_submission_array[index] = index;
+
+			_pending_submissions += 1;
+
+			return submission;
+		}
+
+		void IOURingMonitor::flush_submissions ()
+		{
+			// Publish the queued submissions to the kernel. They are actually submitted by the next call to io_uring_enter.
+			__atomic_store_n(_submission_tail, *_submission_tail + _pending_submissions, __ATOMIC_RELEASE);
+		}
+
+		static __u32 poll_events_for (int events)
+		{
+			__u32 poll_events = 0;
+
+			if (events & READ_READY)
+				poll_events |= POLLIN;
+
+			if (events & WRITE_READY)
+				poll_events |= POLLOUT;
+
+			return poll_events;
+		}
+
+		void IOURingMonitor::submit_poll (Registration * registration)
+		{
+			// A source with no interest is not polled, otherwise hangups and errors would still be reported:
+			if (registration->events == 0) {
+				registration->idle = true;
+				return;
+			}
+
+			struct io_uring_sqe * submission = next_submission();
+
+			submission->opcode = IORING_OP_POLL_ADD;
+			submission->fd = registration->source->file_descriptor();
+			submission->user_data = (__u64)registration;
+			submission->poll32_events = poll_events_for(registration->events);
+
+			registration->armed = true;
+			registration->idle = false;
+		}
+
+		void IOURingMonitor::submit_poll_update (Registration * registration)
+		{
+			struct io_uring_sqe * submission = next_submission();
+
+			submission->opcode = IORING_OP_POLL_REMOVE;
+			submission->fd = -1;
+			submission->len = IORING_POLL_UPDATE_EVENTS;
+			submission->addr = (__u64)registration;
+			submission->poll32_events = poll_events_for(registration->events);
+
+			// If the poll request has already completed, the update fails, but the registration is re-armed with the new interest anyway.
+			submission->user_data = 0;
+		}
+
+		void IOURingMonitor::submit_poll_remove (Registration * registration)
+		{
+			struct io_uring_sqe * submission = next_submission();
+
+			submission->opcode = IORING_OP_POLL_REMOVE;
+			submission->fd = -1;
+			submission->addr = (__u64)registration;
+
+			// Completions with no user data are ignored.
+			submission->user_data = 0;
+		}
+
+		void IOURingMonitor::retire (Registration * registration)
+		{
+			// A removed registration can be deleted once its poll request can no longer complete:
+			if (registration->removed && !registration->armed) {
+				_retired.erase(registration);
+				delete registration;
+			}
+		}
+
+		void IOURingMonitor::add_source (Ptr<IFileDescriptorSource> source, int events)
+		{
+			if (_registrations.find(source.get()) != _registrations.end())
+				return;
+
+			Registration * registration = new Registration;
+			registration->source = source;
+			registration->events = events;
+			registration->armed = registration->idle = registration->removed = false;
+
+			_registrations[source.get()] = registration;
+
+			submit_poll(registration);
+		}
+
+		void IOURingMonitor::remove_source (Ptr<IFileDescriptorSource> source)
+		{
+			auto iterator = _registrations.find(source.get());
+
+			if (iterator == _registrations.end())
+				return;
+
+			Registration * registration = iterator->second;
+			_registrations.erase(iterator);
+
+			registration->removed = true;
+			_retired.insert(registration);
+
+			// If the poll request is in flight, cancel it and retire the registration when it completes. Otherwise, the registration is idle, currently being dispatched or waiting to be re-armed, and will be retired at that point.
+			if (registration->armed)
+				submit_poll_remove(registration);
+			else if (registration->idle)
+				retire(registration);
+		}
+
+		void IOURingMonitor::set_interest (Ptr<IFileDescriptorSource> source, int events)
+		{
+			auto iterator = _registrations.find(source.get());
+
+			if (iterator == _registrations.end())
+				return;
+
+			Registration * registration = iterator->second;
+
+			if (registration->events == events)
+				return;
+
+			registration->events = events;
+
+			// The update is submitted along with the next wait, so it doesn't require a system call:
+			if (registration->armed)
+				submit_poll_update(registration);
+			else if (registration->idle)
+				submit_poll(registration);
+		}
+
+		std::size_t IOURingMonitor::source_count () const
+		{
+			return _registrations.size();
+		}
+
+		std::size_t IOURingMonitor::wait_for_events (TimeT timeout, Loop * loop)
+		{
+			for (auto registration : _rearm) {
+				if (registration->removed)
+					retire(registration);
+				else
+					submit_poll(registration);
+			}
+
+			_rearm.clear();
+
+			flush_submissions();
+
+			unsigned head = *_completion_head;
+			bool completions_available = head != __atomic_load_n(_completion_tail, __ATOMIC_ACQUIRE);
+
+			unsigned min_complete = 0, flags = 0;
+
+			struct __kernel_timespec timespec;
+			struct io_uring_getevents_arg argument = {};
+
+			// If there are already completions available, we don't need to wait:
+			if (timeout != 0 && !completions_available) {
+				min_complete = 1;
+				flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+
+				if (timeout > 0.0) {
+					timespec.tv_sec = timeout;
+					timespec.tv_nsec = (timeout - timespec.tv_sec) * 1000000000;
+
+					argument.ts = (__u64)&timespec;
+				}
+			}
+
+			if (_pending_submissions || min_complete) {
+				SystemError::reset();
+
+				TimeT started = loop->stopwatch().time();
+
+				int result = enter(_pending_submissions, min_complete, flags, flags ? &argument : NULL, flags ? sizeof(argument) : 0);
+
+				if (min_complete)
+					loop->blocked(loop->stopwatch().time() - started);
+
+				if (result < 0 && errno != ETIME && errno != EINTR) {
+					SystemError::check("io_uring_enter");
+				}
+
+				// Submission failures are reported through completions, so all pending submissions are consumed:
+				if (result >= 0 || errno == ETIME || errno == EINTR)
+					_pending_submissions = 0;
+			}
+
+			// Reap all available completions before dispatching, as dispatching may queue further submissions. The buffer is taken from the monitor, in case a source runs the loop again:
+			std::vector<std::pair<Registration *, int>> ready;
+			ready.swap(_ready);
+
+			unsigned tail = __atomic_load_n(_completion_tail, __ATOMIC_ACQUIRE);
+
+			for (head = *_completion_head; head != tail; head += 1) {
+				struct io_uring_cqe & completion = _completions[head & *_completion_mask];
+
+				if (completion.user_data == 0)
+					continue;
+
+				Registration * registration = (Registration *)completion.user_data;
+				registration->armed = false;
+
+				if (registration->removed) {
+					retire(registration);
+				} else {
+					ready.push_back(std::make_pair(registration, completion.res));
+				}
+			}
+
+			__atomic_store_n(_completion_head, head, __ATOMIC_RELEASE);
+
+			std::size_t count = 0;
+
+			for (auto & item : ready) {
+				Registration * registration = item.first;
+				int result = item.second;
+
+				// The registration may have been removed by an earlier source in this batch:
+				if (registration->removed) {
+					retire(registration);
+					continue;
+				}
+
+				Ref<IFileDescriptorSource> source = registration->source;
+
+				if (result < 0 || (result & POLLNVAL)) {
+					log_error("Error polling file descriptor:", source->file_descriptor());
+					remove_source(source);
+					retire(registration);
+
+					continue;
+				}
+
+				int e = 0;
+
+				if (result & POLLIN)
+					e |= READ_READY;
+
+				if (result & POLLOUT)
+					e |= WRITE_READY;
+
+				// Hangups and errors are reported as whatever the source is interested in, so that it observes them when it reads or writes:
+				if (result & (POLLHUP|POLLERR))
+					e |= registration->events;
+
+				// The interest may have been changed since the poll request was submitted:
+				e &= registration->events;
+
+				if (e == 0) {
+					_rearm.push_back(registration);
+					continue;
+				}
+
+				count += 1;
+
+				try {
+					Loop::Dispatch dispatch(loop, typeid(*source), source->file_descriptor());
+					source->process_events(loop, Event(e));
+				} catch (FileDescriptorClosed & ex) {
+					remove_source(source);
+				} catch (std::runtime_error & ex) {
+					log_error("Exception thrown by runloop:", ex.what());
+					log_error("Removing file descriptor:", source->file_descriptor());
+
+					remove_source(source);
+				}
+
+				if (registration->removed)
+					retire(registration);
+				else if (!registration->armed)
+					_rearm.push_back(registration);
+			}
+
+			ready.clear();
+			_ready.swap(ready);
+
+			return count;
+		}
+#endif
+
+// MARK: -
+
+		static Ref<IMonitor> create_monitor (MonitorType monitor_type)
+		{
+			switch (monitor_type) {
+#if defined(TARGET_OS_LINUX)
+				case POLL_MONITOR:
+					return new PollMonitor;
+
+				case EPOLL_MONITOR:
+					return new EPollMonitor;
+
+	#if defined(DREAM_USE_IO_URING)
+				case IO_URING_MONITOR:
+					try {
+						return new IOURingMonitor;
+					} catch (std::exception & error) {
+						log_warning("io_uring is not available:", error.what());
+
+						return new SystemMonitor;
+					}
+	#endif
+#elif defined(TARGET_OS_MAC)
+				case KQUEUE_MONITOR:
+					return new KQueueMonitor;
+#endif
+				case SYSTEM_MONITOR:
+					return new SystemMonitor;
+
+				default:
+					log_warning("Monitor type", monitor_type, "is not available, using system monitor.");
+					return new SystemMonitor;
+			}
+		}
+
+// MARK: -
+// MARK: class Loop
+
+		Loop::Loop (MonitorType monitor_type) : _load(0), _blocked(0), _published_trace(nullptr), _spinning(false), _busy_poll(0), _spin_budget(0), _time_budget(0.005), _time_used(0), _timer_cost(0), _notification_cost(0), _file_descriptors_cost(0), _stop_when_idle(true), _timer_slack(0)
+		{
+			// Setup file descriptor monitor
+			_monitor = create_monitor(monitor_type);
+
+			// Setup timers
+			_stopwatch.start();
+
+			// Create and open an urgent notification pipe
+			_urgent_notification_pipe = new NotificationPipeSource;
+			monitor(_urgent_notification_pipe, READ_READY);
+		}
+
+		Loop::~Loop ()
+		{
+			// Remove the internal urgent notification pipe
+			//std::cerr << "Stop monitoring urgent notification pipe..." << std::endl;
+			//stop_monitoring_file_descriptor(_urgent_notification_pipe);
+
+			//foreach(Ref<IFileDescriptorSource> source, _file_descriptor_handles)
+			//{
+			//	std::cerr << "FD Still Scheduled: " << source->class_name() << source->file_descriptor() << std::endl;
+			//}
+		}
+
+		void Loop::set_stop_when_idle (bool stop_when_idle)
+		{
+			_stop_when_idle = stop_when_idle;
+		}
+
+		void Loop::set_timer_queue (TimerQueueType type)
+		{
+			_timers.set_type(type, _stopwatch.time());
+		}
+
+		void Loop::set_timer_slack (TimeT slack)
+		{
+			DREAM_ASSERT(slack >= 0);
+
+			_timer_slack = slack;
+		}
+
+		void Loop::set_time_budget (TimeT budget)
+		{
+			DREAM_ASSERT(budget >= 0);
+
+			_time_budget = budget;
+		}
+
+		void Loop::set_busy_poll (TimeT maximum)
+		{
+			DREAM_ASSERT(maximum >= 0);
+
+			_busy_poll = _spin_budget = maximum;
+		}
+
+		const Stopwatch & Loop::stopwatch () const
+		{
+			return _stopwatch;
+		}
+
+		bool Loop::on_loop_thread () const
+		{
+			return std::this_thread::get_id() == _current_thread;
+		}
+
+		std::size_t Loop::load () const
+		{
+			return _load.load(std::memory_order_relaxed);
+		}
+
+		void Loop::blocked (TimeT duration)
+		{
+			_blocked += duration;
+			_metrics.blocked_time.add(nanoseconds(duration));
+
+			if (_trace) {
+				std::uint64_t now = Trace::now();
+				_trace->complete("blocked", now - nanoseconds(duration), nanoseconds(duration));
+			}
+		}
+
+		void Loop::set_trace (Ref<Trace> trace)
+		{
+			if (_trace)
+				_retired_traces.push_back(_trace);
+
+			_trace = trace;
+			_published_trace.store(trace.get(), std::memory_order_release);
+		}
+
+		void Loop::update_load ()
+		{
+			// We have 1 "hidden" source: _urgent_notification_pipe:
+			_load.store(_monitor->source_count() - 1 + _timers.size() + _notifications[HIGH_PRIORITY].processing_count + _notifications[NORMAL_PRIORITY].processing_count + _notifications[LOW_PRIORITY].processing_count, std::memory_order_relaxed);
+		}
+
+// MARK: -
+
+		TimerHandle Loop::schedule_timer (Ref<ITimerSource> source)
+		{
+			// The handle is reserved up front, so that it can be used before the timer has been added:
+			TimerHandle handle = _timers.reserve();
+
+			if (std::this_thread::get_id() == _current_thread) {
+				insert_timer(handle, source);
+			} else {
+				if (DEBUG) log_debug("Posting notification to remote event loop");
+
+				// If the event loop is currently running forever with a timeout of -1, the notification will never be processed unless it is set to urgent. It might be better to have a default timeout for the runloop and expose this behaviour to the client library rather than just posting all schedule timer notifcations as urgent.
+				this->post_urgent([source, handle](Loop * loop) {
+					loop->insert_timer(handle, source);
+				});
+			}
+
+			return handle;
+		}
+
+		void Loop::insert_timer (const TimerHandle & handle, Ref<ITimerSource> source)
+		{
+			TimeT current_time = _stopwatch.time();
+
+			// The timer may have been cancelled before it was added:
+			if (_timers.insert(handle, source->next_timeout(current_time, current_time), source, current_time))
+				source->scheduled(this, handle);
+		}
+
+		/// Schedules a batch of timers posted from a separate thread.
+		struct ScheduleTimers {
+			std::vector<Ref<ITimerSource>> sources;
+
+			void operator() (Loop * loop)
+			{
+				for (auto & source : sources)
+					loop->schedule_timer(source);
+			}
+		};
+
+		void Loop::schedule_timer_batch (std::vector<Ref<ITimerSource>> && sources)
+		{
+			if (std::this_thread::get_id() == _current_thread) {
+				for (auto & source : sources)
+					schedule_timer(source);
+			} else if (!sources.empty()) {
+				// The vector is moved into the notification, so the timers are added with a single notification and without copying their references:
+				this->post_urgent(ScheduleTimers{std::move(sources)});
+			}
+		}
+
+		bool Loop::cancel_timer (TimerHandle handle)
+		{
+			if (std::this_thread::get_id() == _current_thread) {
+				return _timers.remove(handle);
+			} else {
+				this->post_urgent([handle](Loop * loop) {
+					loop->cancel_timer(handle);
+				});
+
+				return true;
+			}
+		}
+
+		bool Loop::reschedule_timer (TimerHandle handle, TimeT timeout)
+		{
+			if (std::this_thread::get_id() == _current_thread) {
+				TimeT current_time = _stopwatch.time();
+
+				return _timers.reschedule(handle, current_time + timeout, current_time);
+			} else {
+				this->post_urgent([handle, timeout](Loop * loop) {
+					loop->reschedule_timer(handle, timeout);
+				});
+
+				return true;
+			}
+		}
+
+// MARK: -
+
+		void Loop::post_notification (Ref<INotificationSource> note, NotificationPriority priority, TimeT deadline)
+		{
+			if (std::this_thread::get_id() == _current_thread) {
+				note->process_events(this, NOTIFICATION);
+			} else {
+				Notifications::Node * node = Notifications::allocate();
+				node->source = note;
+
+				post_node(node, priority == HIGH_PRIORITY || deadline >= 0, priority, deadline);
+			}
+		}
+
+		void Loop::post_notification (Ref<INotificationSource> note, bool urgent)
+		{
+			// Lock the event loop notification queue
+			// Add note to the end of the queue
+			// Interrupt event loop thread if urgent
+
+			if (std::this_thread::get_id() == _current_thread) {
+				note->process_events(this, NOTIFICATION);
+			} else {
+				// Enqueue the notification to be processed, interrupting the event loop thread if urgent so that it processes notifications more quickly:
+				Notifications::Node * node = Notifications::allocate();
+				node->source = note;
+
+				post_node(node, urgent);
+			}
+		}
+
+		void Loop::post_nodes (Notifications::Node * first, Notifications::Node * last, bool urgent, NotificationPriority priority, TimeT deadline)
+		{
+			DREAM_ASSERT(priority < PRIORITIES);
+
+			// This may be called from any thread, so it must not touch _trace, which belongs to the loop thread:
+			bool tracing = _published_trace.load(std::memory_order_relaxed) != nullptr;
+			std::uint64_t now = (tracing || deadline >= 0) ? Trace::now() : 0;
+
+			for (Notifications::Node * node = first; ; node = node->next) {
+				if (tracing) {
+					node->posted = now;
+					node->producer = Trace::current_thread();
+				} else {
+					node->posted = 0;
+				}
+
+				node->deadline = deadline >= 0 ? now + nanoseconds(deadline) : 0;
+
+				if (node == last)
+					break;
+			}
+
+			_notifications[priority].push(first, last);
+
+			// A spinning loop will find the notification without being woken up. This is sequentially consistent with the loop clearing the flag and then checking for notifications:
+			if (urgent && !_spinning.load())
+				_urgent_notification_pipe->notify_event_loop();
+		}
+
+		void Loop::monitor (Ptr<IFileDescriptorSource> source)
+		{
+			DREAM_ASSERT(source->file_descriptor() != -1);
+
+			monitor(source, events_for_file_descriptor(source->file_descriptor()));
+		}
+
+		void Loop::monitor (Ptr<IFileDescriptorSource> source, int events)
+		{
+			DREAM_ASSERT(source->file_descriptor() != -1);
+			//std::cerr << this << " monitoring fd: " << fd << std::endl;
+			//IFileDescriptorSource::debug_file_descriptor_flags(fd);
+
+			_monitor->add_source(source, events);
+		}
+
+		void Loop::set_interest (Ptr<IFileDescriptorSource> source, int events)
+		{
+			_monitor->set_interest(source, events);
+		}
+
+		void Loop::stop_monitoring_file_descriptor (Ptr<IFileDescriptorSource> source)
+		{
+			DREAM_ASSERT(source->file_descriptor() != -1);
+
+			if (DEBUG) log_debug("Event loop removing file descriptor:", source->file_descriptor());
+
+			//IFileDescriptorSource::debug_file_descriptor_flags(fd);
+
+			_monitor->remove_source(source);
+		}
+
+		TimeT Loop::slacken (TimeT timeout)
+		{
+			// Round the wakeup up to the next multiple of the slack, so that all timers due before then are processed together:
+			if (_timer_slack > 0) {
+				TimeT current_time = _stopwatch.time();
+				timeout = std::ceil((current_time + timeout) / _timer_slack) * _timer_slack - current_time;
+			}
+
+			return timeout;
+		}
+
+		/// If there is a timeout, returns true and the timeout in `at_time`.
+		/// If there isn't a timeout, returns false and -1 in `at_time`.
+		bool Loop::next_timeout (TimeT & at_time)
+		{
+			if (_timers.next_timeout(at_time)) {
+				at_time -= _stopwatch.time();
+				return true;
+			} else {
+				at_time = -1;
+				return false;
+			}
+		}
+
+		void Loop::stop ()
+		{
+			if (std::this_thread::get_id() != _current_thread) {
+				post_notification(NotificationSource::stop_loop_notification(), HIGH_PRIORITY);
+			} else {
+				_running = false;
+			}
+		}
+
+		/// The nodes cached by the current thread. Nodes released on this thread are kept in a separate list so that they can be returned in one batch.
+		struct Loop::Notifications::Cache {
+			Node * acquired = nullptr;
+
+			Node * released = nullptr, * last = nullptr;
+			std::size_t count = 0;
+
+			/// The number of released nodes which are kept before they are returned for other threads to use.
+			static const std::size_t LIMIT = 64;
+
+			/// Return a list of nodes for other threads to use, with a single atomic operation.
+			static void give (Node * first, Node * last)
+			{
+				last->next = returned.load(std::memory_order_relaxed);
+
+				while (!returned.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {
+				}
+			}
+
+			~Cache ()
+			{
+				// When the thread exits, its nodes are kept for other threads:
+				if (released)
+					give(released, last);
+
+				if (acquired) {
+					Node * tail = acquired;
+
+					while (tail->next)
+						tail = tail->next;
+
+					give(acquired, tail);
+				}
+			}
+		};
+
+		std::atomic<Loop::Notifications::Node *> Loop::Notifications::returned(nullptr);
+
+		Loop::Notifications::Cache & Loop::Notifications::cache ()
+		{
+			static thread_local Cache cache;
+
+			return cache;
+		}
+
+		Loop::Notifications::Node * Loop::Notifications::allocate ()
+		{
+			Cache & cache = Notifications::cache();
+			Node * node = nullptr;
+
+			if (cache.released) {
+				node = cache.released;
+				cache.released = node->next;
+				cache.count -= 1;
+
+				if (cache.released == nullptr)
+					cache.last = nullptr;
+			} else {
+				// Take all the nodes returned by other threads, this is safe from ABA as nodes are never removed individually:
+				if (cache.acquired == nullptr)
+					cache.acquired = returned.exchange(nullptr, std::memory_order_acquire);
+
+				if (cache.acquired) {
+					node = cache.acquired;
+					cache.acquired = node->next;
+				} else {
+					node = new Node;
+				}
+			}
+
+			node->next = nullptr;
+			node->callback = nullptr;
+
+			return node;
+		}
+
+		void Loop::Notifications::release (Node * node)
+		{
+			Cache & cache = Notifications::cache();
+
+			node->source = nullptr;
+
+			if (cache.last == nullptr)
+				cache.last = node;
+
+			node->next = cache.released;
+			cache.released = node;
+			cache.count += 1;
+
+			if (cache.count >= Cache::LIMIT) {
+				Cache::give(cache.released, cache.last);
+
+				cache.released = cache.last = nullptr;
+				cache.count = 0;
+			}
+		}
+
+		Loop::Notifications::Notifications () : sources(nullptr), processing(nullptr), processing_count(0)
+		{
+		}
+
+		Loop::Notifications::~Notifications ()
+		{
+			// Discard any notifications left over from a call which used up the time budget, followed by any which were never fetched:
+			while (processing) {
+				pop(nullptr);
+			}
+
+			swap();
+
+			while (processing) {
+				pop(nullptr);
+			}
+		}
+
+		void Loop::Notifications::push (Node * first, Node * last)
+		{
+			last->next = sources.load(std::memory_order_relaxed);
+
+			// This is sequentially consistent with respect to the urgent notification flag, so that the loop can't miss a notification which was posted without waking it up:
+			while (!sources.compare_exchange_weak(last->next, first)) {
+			}
+		}
+
+		bool Loop::Notifications::empty () const
+		{
+			// This is sequentially consistent, so that a spinning loop can't miss a notification posted without waking it up:
+			return sources.load() == nullptr;
+		}
+
+		std::size_t Loop::Notifications::swap ()
+		{
+			DREAM_ASSERT(processing == nullptr);
+
+			// Grab all pending notifications
+			Node * node = sources.exchange(nullptr);
+			std::size_t count = 0;
+			bool deadlines = false;
+
+			// The list is most recent first, so reverse it to process notifications in the order they were posted:
+			while (node) {
+				Node * next = node->next;
+
+				node->next = processing;
+				processing = node;
+
+				if (node->deadline)
+					deadlines = true;
+
+				node = next;
+				count += 1;
+			}
+
+			if (deadlines)
+				processing = sort(processing, count);
+
+			processing_count = count;
+
+			return count;
+		}
+
+		Loop::Notifications::Node * Loop::Notifications::sort (Node * list, std::size_t count)
+		{
+			if (count < 2)
+				return list;
+
+			// Split the list in half:
+			Node * middle = list;
+
+			for (std::size_t i = 1; i < count / 2; i += 1)
+				middle = middle->next;
+
+			Node * second = middle->next;
+			middle->next = nullptr;
+
+			Node * first = sort(list, count / 2);
+			second = sort(second, count - count / 2);
+
+			// Merge the halves, preferring the first so that the sort is stable:
+			Node * head = nullptr, ** tail = &head;
+
+			while (first && second) {
+				std::uint64_t a = first->deadline ? first->deadline : ~std::uint64_t(0);
+				std::uint64_t b = second->deadline ? second->deadline : ~std::uint64_t(0);
+
+				if (b < a) {
+					*tail = second;
+					second = second->next;
+				} else {
+					*tail = first;
+					first = first->next;
+				}
+
+				tail = &(*tail)->next;
+			}
+
+			*tail = first ? first : second;
+
+			return head;
+		}
+
+		void Loop::Notifications::pop (Loop * loop)
+		{
+			Node * node = processing;
+			processing = node->next;
+			processing_count -= 1;
+
+			// The node is released even if the notification throws:
+			struct Release {
+				Node * node;
+
+				~Release () { release(node); }
+			} guard = {node};
+
+			if (node->callback)
+				node->callback(node, loop);
+			else if (loop)
+				node->source->process_events(loop, NOTIFICATION);
+		}
+
+		TimeT Loop::available_time () const
+		{
+			// File descriptors are set aside at most half of the budget, so that timers and notifications still make progress while file descriptors are busy:
+			TimeT reserved = std::min(_file_descriptors_cost, _time_budget / 2);
+
+			return std::max<TimeT>(_time_budget - reserved - _time_used, 0);
+		}
+
+		/// Limits processing to the time allowed. Items are processed in batches sized using the measured cost of each item, so that the clock is only read between batches. At least one item is always processed. The time spent is added to the time used by the current iteration.
+		struct Loop::Budget {
+			/// Limits the damage if an item is much more expensive than the items before it.
+			static const std::size_t MAXIMUM_BATCH = 64;
+
+			Loop * loop;
+			TimeT & cost;
+			TimeT allowed, started, spent;
+
+			// The current batch:
+			TimeT batch_started;
+			std::size_t batch_size, batch_count;
+
+			Budget (Loop * loop_, TimeT & cost_, TimeT allowed_) : loop(loop_), cost(cost_), allowed(allowed_), started(loop_->_stopwatch.time()), spent(0), batch_started(started), batch_size(size(allowed_)), batch_count(0)
+			{
+			}
+
+			~Budget ()
+			{
+				if (loop->_time_budget > 0) {
+					measure(loop->_stopwatch.time());
+					loop->_time_used += spent;
+				}
+			}
+
+			std::size_t size (TimeT remaining) const
+			{
+				if (cost <= 0)
+					return MAXIMUM_BATCH;
+
+				return std::max<std::size_t>(1, std::min<TimeT>(MAXIMUM_BATCH, remaining / cost));
+			}
+
+			void measure (TimeT now)
+			{
+				if (batch_count) {
+					cost += ((now - batch_started) / batch_count - cost) / 8;
+					batch_count = 0;
+				}
+
+				spent = now - started;
+				batch_started = now;
+			}
+
+			/// Call before processing each item.
+			/// @returns false if the time allowed has been used up.
+			bool next ()
+			{
+				if (loop->_time_budget <= 0)
+					return true;
+
+				if (batch_count == batch_size) {
+					measure(loop->_stopwatch.time());
+
+					if (spent >= allowed)
+						return false;
+
+					batch_size = size(allowed - spent);
+				}
+
+				batch_count += 1;
+
+				return true;
+			}
+		};
+
+		bool Loop::notifications_pending (std::size_t priority) const
+		{
+			for (; priority < PRIORITIES; priority += 1) {
+				if (_notifications[priority].processing || !_notifications[priority].empty())
+					return true;
+			}
+
+			return false;
+		}
+
+		void Loop::process_notifications ()
+		{
+			// Escape quickly if there is nothing to do:
+			if (!notifications_pending())
+				return;
+
+			TraceScope scope(_trace, "process_notifications");
+
+			TimeT started = _stopwatch.time();
+
+			for (std::size_t priority = 0; priority < PRIORITIES; priority += 1) {
+				Notifications & notifications = _notifications[priority];
+
+				// Notifications left over from a previous call are processed first, before fetching any new ones:
+				if (notifications.processing == nullptr) {
+					if (notifications.empty())
+						continue;
+
+					std::size_t count = notifications.swap();
+					_metrics.notification_depth.record(count);
+
+					if (DEBUG) log_debug("Processing", count, "notifications with priority", priority);
+				}
+
+				// Notifications can use whatever time timers and higher priorities didn't, but while lower priorities are waiting, a quarter of it is left for them:
+				TimeT allowed = available_time();
+
+				if (notifications_pending(priority + 1))
+					allowed -= allowed / 4;
+
+				Budget budget(this, _notification_cost, allowed);
+
+				while (notifications.processing) {
+					if (!budget.next()) {
+						// The remaining notifications stay in the processing list and are processed on the next iteration of the event loop:
+						if (DEBUG) log_warning("Notifications have used up the time budget!");
+						_metrics.notifications_deferred.add();
+
+						break;
+					}
+
+					Notifications::Node * node = notifications.processing;
+
+					if (node->deadline && Trace::now() > node->deadline)
+						_metrics.notifications_late.add();
+
+					// Functions posted using post() are identified by their type:
+					Dispatch dispatch(this, node->callback ? *node->type : typeid(*node->source));
+
+					if (dispatch.trace && node->posted)
+						dispatch.trace->flow(node->posted, node->producer);
+
+					notifications.pop(this);
+				}
+			}
+
+			_metrics.notifications_time.record(nanoseconds(_stopwatch.time() - started));
+
+			update_load();
+		}
+
+		TimeT Loop::process_timers()
+		{
+			TraceScope scope(_trace, "process_timers");
+
+			TimeT started = _stopwatch.time();
+			TimeT timeout = process_due_timers();
+
+			_metrics.timers_time.record(nanoseconds(_stopwatch.time() - started));
+
+			return timeout;
+		}
+
+		TimeT Loop::process_due_timers ()
+		{
+			TimeT timeout = -1;
+
+			// Timers can use half of the time available while notifications are waiting, so that neither can starve the other:
+			TimeT allowed = available_time();
+
+			if (notifications_pending())
+				allowed /= 2;
+
+			Budget budget(this, _timer_cost, allowed);
+
+			// next_timeout returns true if the timeout should be processed, and updates timeout with the time it was due
+			while (next_timeout(timeout)) {
+				if (DEBUG) log_debug("Timeout at:", timeout);
+
+				if (timeout > 0.0) {
+					// The timeout was in the future:
+					timeout = slacken(timeout);
+
+					break;
+				}
+
+				TimerHandle handle;
+				TimeT due;
+				Ref<ITimerSource> source;
+
+				// A timing wheel may need to cascade timers before they are due, in which case there is no timer to process yet:
+				if (!_timers.pop(_stopwatch.time(), handle, due, source))
+					continue;
+
+				if (!budget.next()) {
+					if (DEBUG) log_warning("Timers have used up the time budget!");
+					_metrics.timers_deferred.add();
+
+					// The timer is still due, and will be processed first on the next iteration of the event loop:
+					_timers.requeue(handle, due, _stopwatch.time());
+
+					return 0.0;
+				}
+
+				// Check if the timeout is late:
+				_metrics.timer_lateness.record(nanoseconds(-timeout));
+
+				if (timeout < -0.1 && DEBUG)
+					log_warning("Timeout was late:", timeout);
+
+				{
+					Dispatch dispatch(this, typeid(*source));
+					source->process_events(this, TIMEOUT);
+				}
+
+				// The timer may have cancelled or rescheduled itself, in which case it is no longer running:
+				if (_timers.running(handle)) {
+					if (source->repeats()) {
+						// Calculate the next time to schedule.
+						TimeT current_time = _stopwatch.time();
+						_timers.requeue(handle, source->next_timeout(due, current_time), current_time);
+					} else {
+						_timers.remove(handle);
+					}
+				}
+			}
+
+			if (DEBUG) log_debug("process_timers finished with timeout:", timeout);
+
+			return timeout;
+		}
+
+		/// Hint to the processor that the thread is spinning.
+		static inline void relax ()
+		{
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			asm volatile("yield");
+#endif
+		}
+
+		bool Loop::spin (TimeT timeout)
+		{
+			TimeT budget = _spin_budget;
+
+			if (timeout >= 0 && timeout < budget)
+				budget = timeout;
+
+			_metrics.spins.add();
+
+			TraceScope scope(_trace, "spin");
+
+			_spinning.store(true);
+
+			TimeT started = _stopwatch.time();
+			bool found = false;
+
+			while (true) {
+				if (notifications_pending()) {
+					found = true;
+					break;
+				}
+
+				if (_monitor->wait_for_events(0, this) > 0) {
+					found = true;
+					break;
+				}
+
+				if (_stopwatch.time() - started >= budget)
+					break;
+
+				relax();
+			}
+
+			_spinning.store(false);
+
+			// Urgent notifications posted while the loop was spinning didn't wake it up:
+			if (notifications_pending())
+				found = true;
+
+			if (found)
+				_metrics.spin_hits.add();
+
+			return found;
+		}
+
+		void Loop::adapt_spin_budget (bool spun, bool found)
+		{
+			// Spinning for longer is only worthwhile if events arrive within the maximum time to spin:
+			if (found || _blocked <= _busy_poll) {
+				if (_spin_budget == 0)
+					_spin_budget = _busy_poll / 8;
+				else
+					_spin_budget = std::min(_spin_budget * 2, _busy_poll);
+			} else if (spun) {
+				_spin_budget /= 2;
+
+				if (_spin_budget < _busy_poll / 64)
+					_spin_budget = 0;
+			}
+		}
+
+		void Loop::process_file_descriptors (TimeT timeout)
+		{
+			if (DEBUG) log_debug("process_file_descriptors timeout:", timeout);
+
+			// Timeout is now the amount of time we have to process other events until another timeout will need to fire.
+			TraceScope scope(_trace, "process_file_descriptors");
+			TimeT started = _stopwatch.time();
+
+			// Time spent blocked, or processing urgent notifications, is not part of the cost of file descriptors:
+			TimeT excluded = _blocked + _time_used;
+
+			// The loop is considered to be waiting unless it's dispatching an event:
+			_activity.state.store(LoopActivity::WAITING, std::memory_order_relaxed);
+
+			if (_monitor->source_count()) {
+				std::size_t count = _monitor->wait_for_events(timeout, this);
+				_metrics.ready_file_descriptors.record(count);
+			} else if (timeout > 0.0) {
+				Core::sleep(timeout);
+				blocked(_stopwatch.time() - started);
+			}
+
+			_activity.state.store(LoopActivity::RUNNING, std::memory_order_relaxed);
+
+			TimeT elapsed = _stopwatch.time() - started;
+			_metrics.file_descriptors_time.record(nanoseconds(elapsed));
+
+			TimeT cost = std::max<TimeT>(elapsed - (_blocked + _time_used - excluded), 0);
+			_file_descriptors_cost += (cost - _file_descriptors_cost) / 8;
+		}
+
+		static thread_local Loop * current_loop = nullptr;
+
+		Loop * Loop::current ()
+		{
+			return current_loop;
+		}
+
+		/// Sets the current loop for the duration of an iteration, restoring the previous one afterwards in case loops are nested.
+		struct CurrentLoop {
+			Loop * previous;
+
+			CurrentLoop (Loop * loop) : previous(current_loop) { current_loop = loop; }
+			~CurrentLoop () { current_loop = previous; }
+		};
+
+		/// Records the time spent processing events during an iteration, i.e. the time which wasn't spent blocked.
+		struct Loop::Iteration {
+			Loop * loop;
+			TimeT started;
+
+			int state;
+
+			Iteration (Loop * loop_) : loop(loop_), started(loop_->_stopwatch.time())
+			{
+				loop->_blocked = 0;
+				loop->_time_used = 0;
+
+				LoopActivity & activity = loop->_activity;
+				activity.beat();
+				activity.thread.store(pthread_self(), std::memory_order_relaxed);
+
+				// Loops can be nested, e.g. by running a loop from a notification:
+				state = activity.state.load(std::memory_order_relaxed);
+				activity.state.store(LoopActivity::RUNNING, std::memory_order_relaxed);
+			}
+
+			~Iteration ()
+			{
+				LoopActivity & activity = loop->_activity;
+
+				if (state == LoopActivity::RUNNING) {
+					activity.state.store(state, std::memory_order_relaxed);
+				} else {
+					// The thread may exit once the loop stops running, so it must not be signalled after this point (see LoopActivity::interrupt):
+					activity.state.store(state);
+
+					while (activity.interrupting.load())
+						std::this_thread::yield();
+				}
+
+				loop->_metrics.iterations.add();
+				loop->_metrics.busy_time.add(nanoseconds(loop->_stopwatch.time() - started - loop->_blocked));
+			}
+		};
+
+		void Loop::run_one_iteration (bool use_timer_timeout, TimeT timeout)
+		{
+			CurrentLoop current(this);
+			Iteration iteration(this);
+			TraceScope scope(_trace, "run_one_iteration");
+
 			if (DEBUG) log_debug("Loop::run_one_iteration use_timer_timeout:", use_timer_timeout, "timeout:", timeout);
 
 			TimeT time_until_next_timer_event = process_timers();
@@ -638,22 +2241,50 @@ namespace Dream
 			// Process notifications before waiting for IO... [optional - reduce notification latency]
 			process_notifications();
 
+			// Notifications may have scheduled timers which are due before the next timer:
+			TimeT time_until_scheduled_timer_event;
+
+			if (time_until_next_timer_event != 0 && next_timeout(time_until_scheduled_timer_event)) {
+				time_until_scheduled_timer_event = slacken(std::max(time_until_scheduled_timer_event, (TimeT)0));
+
+				if (time_until_next_timer_event < 0 || time_until_scheduled_timer_event < time_until_next_timer_event)
+					time_until_next_timer_event = time_until_scheduled_timer_event;
+			}
+
 			// We have 1 "hidden" source: _urgent_notification_pipe..
-			if (_stop_when_idle && _monitor->source_count() == 1 && _timer_handles.size() == 0)
+			if (_stop_when_idle && _monitor->source_count() == 1 && _timers.empty())
 				stop();
 
 			// A timer may have stopped the runloop. We should check here before we possibly block indefinitely.
 			if (_running == false)
 				return;
 
-			// If the timeout specified was too big, we set it till the time the next event will occur, so that this function (will/should) be called again shortly and process the timeout as appropriate.
-			if (use_timer_timeout || timeout > time_until_next_timer_event) {
+			// If the timeout specified was too big, we set it till the time the next event will occur, so that this function (will/should) be called again shortly and process the timeout as appropriate. A negative timeout means there are no timers.
+			if (use_timer_timeout || (time_until_next_timer_event >= 0 && (timeout < 0 || timeout > time_until_next_timer_event))) {
 				timeout = time_until_next_timer_event;
 
 				if (DEBUG) log_debug("Loop::run_one_iteration timeout:", timeout);
 			}
 
-			process_file_descriptors(timeout);
+			// If notifications were deferred, don't block so that they are processed promptly. Notifications posted while the urgent notification pipe was being reset may not have been fetched yet, and won't wake the loop:
+			if (notifications_pending())
+				timeout = 0;
+
+			update_load();
+
+			if (_busy_poll > 0 && timeout != 0) {
+				bool spun = _spin_budget > 0, found = false;
+
+				if (spun && spin(timeout))
+					found = true;
+
+				// If there is work to do, file descriptors are still polled once, without blocking:
+				process_file_descriptors(found ? 0 : timeout);
+
+				adapt_spin_budget(spun, found);
+			} else {
+				process_file_descriptors(timeout);
+			}
 
 			// Process any outstanding notifications after IO... [required]
 			process_notifications();
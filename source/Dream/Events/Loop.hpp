@@ -12,15 +12,24 @@
 #include "Events.hpp"
 #include "Source.hpp"
 #include "Monitor.hpp"
+#include "Timers.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
 
 #include <set>
-#include <queue>
+#include <vector>
 
 #include <thread>
-#include <mutex>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <exception>
+#include <memory>
 
 #ifdef BSD
 #define DREAM_USE_KQUEUE
+#elif defined(__linux__)
+#define DREAM_USE_EPOLL
 #else
 #define DREAM_USE_POLL
 #endif
@@ -29,6 +38,19 @@ namespace Dream
 {
 	namespace Events
 	{
+		template <typename FunctionT>
+		class Future;
+
+		/// Selects the order in which a Loop processes notifications. Notifications are processed in order of priority, but while lower priorities are waiting, they are left a share of each iteration so that they can't be starved.
+		enum NotificationPriority {
+			/// Control messages which shouldn't wait behind other work, e.g. stopping the loop or reloading its configuration.
+			HIGH_PRIORITY = 0,
+			/// The priority used by post_notification() and post().
+			NORMAL_PRIORITY = 1,
+			/// Background work which can wait until other notifications have been processed.
+			LOW_PRIORITY = 2
+		};
+
 		/**
 		A run-loop to provide timed and io based event handling.
 
@@ -49,80 +71,381 @@ namespace Dream
 
 			void process_notifications ();
 
+			static const std::size_t PRIORITIES = 3;
+
+			/// A lock-free multiple-producer, single-consumer queue. Producers push onto an atomic list, and the loop takes the entire list with a single atomic exchange.
 			struct Notifications {
-				typedef std::queue<Ref<INotificationSource>> QueueT;
+				/// Callables up to this size are stored inline in the node.
+				static const std::size_t STORAGE_SIZE = 6 * sizeof(void *);
+
+				typedef typename std::aligned_storage<STORAGE_SIZE>::type StorageT;
+
+				struct Node {
+					Node * next;
+					Ref<INotificationSource> source;
+
+					/// Invokes (if the loop is not null) and then destroys a callable posted by Loop::post().
+					void (*callback)(Node * node, Loop * loop);
+					StorageT storage;
+
+					/// The type of the callable, which is used to identify it while it is processed.
+					const std::type_info * type;
+
+					/// When and by which thread the node was posted, if the loop is being traced.
+					std::uint64_t posted;
+					std::uint32_t producer;
+
+					/// The time by which the notification should be processed, as per Trace::now(), or 0 if it doesn't have a deadline.
+					std::uint64_t deadline;
+				};
+
+				/// Stores a callable inline in a node if it fits, otherwise on the heap.
+				template <typename CallableT, bool INLINE = (sizeof(CallableT) <= sizeof(StorageT) && alignof(CallableT) <= alignof(StorageT))>
+				struct Callable {
+					template <typename FunctionT>
+					static void store (Node * node, FunctionT && function)
+					{
+						new(&node->storage) CallableT(std::forward<FunctionT>(function));
+						node->callback = &call;
+						node->type = &typeid(CallableT);
+					}
+
+					static void call (Node * node, Loop * loop)
+					{
+						// The callable is destroyed even if it throws:
+						struct Destroy {
+							CallableT * callable;
+
+							~Destroy () { callable->~CallableT(); }
+						} destroy = {reinterpret_cast<CallableT *>(&node->storage)};
+
+						if (loop)
+							(*destroy.callable)(loop);
+					}
+				};
+
+				template <typename CallableT>
+				struct Callable<CallableT, false> {
+					template <typename FunctionT>
+					static void store (Node * node, FunctionT && function)
+					{
+						*reinterpret_cast<CallableT **>(&node->storage) = new CallableT(std::forward<FunctionT>(function));
+						node->callback = &call;
+						node->type = &typeid(CallableT);
+					}
+
+					static void call (Node * node, Loop * loop)
+					{
+						std::unique_ptr<CallableT> callable(*reinterpret_cast<CallableT **>(&node->storage));
+
+						if (loop)
+							(*callable)(loop);
+					}
+				};
+
+				/// Nodes are pooled per thread. Nodes released by the loop thread are handed back to posting threads in batches, so that posting across threads doesn't allocate once the pool is warm. Nodes are kept for the lifetime of the process. This function is thread-safe.
+				static Node * allocate ();
+				static void release (Node * node);
+
+				struct Cache;
+				static Cache & cache ();
+
+				/// Nodes returned by loop threads, which are taken as a whole by threads that need more nodes.
+				static std::atomic<Node *> returned;
 
 				Notifications ();
-				void swap ();
+				~Notifications ();
+
+				/// Enqueue a list of notifications, linked most recently posted first, with a single atomic operation. This function is thread-safe and doesn't block.
+				void push (Node * first, Node * last);
+
+				/// Whether there are notifications waiting to be fetched by swap(). This function is thread-safe.
+				bool empty () const;
 
-				std::mutex lock;
+				/// Fetch all waiting notifications into the processing list, earliest deadline first, followed by notifications without a deadline in the order they were posted. Must only be called by the loop thread when the processing list is empty.
+				/// @returns the number of notifications fetched.
+				std::size_t swap ();
 
-				/// A queue of notifications that need to be processed
-				QueueT sources;
-				QueueT processing;
+				/// Sort a list by deadline. The sort is stable, and notifications without a deadline are sorted last.
+				static Node * sort (Node * list, std::size_t count);
+
+				/// Remove the first notification from the processing list and process it. If the loop is null, the notification is discarded.
+				void pop (Loop * loop);
+
+				/// The notifications that need to be processed, most recently posted first.
+				std::atomic<Node *> sources;
+
+				/// The notifications being processed by the loop thread, in order.
+				Node * processing;
+
+				/// The number of notifications in the processing list.
+				std::size_t processing_count;
 			};
 
-			Notifications _notifications;
-			std::thread::id _current_thread;
+			// One queue for each priority:
+			Notifications _notifications[PRIORITIES];
+
+			/// Whether any notifications with the given priority or lower have been posted or fetched but not yet processed. This function is sequentially consistent with respect to posting notifications.
+			bool notifications_pending (std::size_t priority = 0) const;
+			// Read by other threads to determine whether a call is local or remote.
+			std::atomic<std::thread::id> _current_thread;
 			bool _running;
 
-			struct TimerHandle {
-				TimeT timeout;
-				Ref<ITimerSource> source;
+			// Published by the loop thread so that other threads can balance work between loops.
+			std::atomic<std::size_t> _load;
+			void update_load ();
 
-				bool operator< (const TimerHandle & other) const
-				{
-					return timeout > other.timeout;
-				}
-			};
+			TimerQueue _timers;
+
+			LoopMetrics _metrics;
+			LoopActivity _activity;
+
+			/// Records which source is being processed, for tracing and detecting stalls. Used by monitors when they dispatch events.
+			struct Dispatch;
+
+			// The time blocked waiting for events during the current iteration, which monitors report using blocked():
+			TimeT _blocked;
+
+			Ref<Trace> _trace;
+
+			// The trace as seen by other threads, e.g. when posting notifications. Traces which are replaced are kept alive until the loop is destroyed, as other threads may still be using them:
+			std::atomic<Trace *> _published_trace;
+			std::vector<Ref<Trace>> _retired_traces;
+
+			friend class PollMonitor;
+			friend class EPollMonitor;
+			friend class KQueueMonitor;
+			friend class IOURingMonitor;
+			friend class Thread;
 
-			typedef std::priority_queue<TimerHandle> TimerHandlesT;
-			TimerHandlesT _timer_handles;
+			void blocked (TimeT duration);
 
 			bool next_timeout (TimeT &);
 
+			/// Extend a timeout within the timer slack.
+			TimeT slacken (TimeT timeout);
+
 			/// Process any timer events that may be pending
 			/// @returns the time until the next timeout if it exists
 			/// @returns -1 if there are no further timeouts
 			TimeT process_timers ();
+			TimeT process_due_timers ();
+
+			template <typename FunctionT>
+			void post_function (FunctionT && function, bool urgent, NotificationPriority priority = NORMAL_PRIORITY, TimeT deadline = -1)
+			{
+				if (std::this_thread::get_id() == _current_thread) {
+					function(this);
+				} else {
+					enqueue_function(std::forward<FunctionT>(function), urgent, priority, deadline);
+				}
+			}
+
+			template <typename FunctionT>
+			void enqueue_function (FunctionT && function, bool urgent, NotificationPriority priority = NORMAL_PRIORITY, TimeT deadline = -1)
+			{
+				typedef typename std::decay<FunctionT>::type CallableT;
+
+				Notifications::Node * node = Notifications::allocate();
+				Notifications::Callable<CallableT>::store(node, std::forward<FunctionT>(function));
+
+				post_node(node, urgent, priority, deadline);
+			}
+
+			void post_node (Notifications::Node * node, bool urgent, NotificationPriority priority = NORMAL_PRIORITY, TimeT deadline = -1)
+			{
+				post_nodes(node, node, urgent, priority, deadline);
+			}
+
+			/// Enqueue a list of nodes, linked most recently posted first, waking the loop at most once.
+			void post_nodes (Notifications::Node * first, Notifications::Node * last, bool urgent, NotificationPriority priority = NORMAL_PRIORITY, TimeT deadline = -1);
+
+			void schedule_timer_batch (std::vector<Ref<ITimerSource>> && sources);
+
+			/// Add a timer using a handle reserved by schedule_timer().
+			void insert_timer (const TimerHandle & handle, Ref<ITimerSource> source);
 
 			/// Process any file descriptors and their events. Timeout supplied as per IMonitor::wait_for_events()
 			void process_file_descriptors (TimeT timeout);
 
+			// Set while the loop is spinning, so that urgent notifications don't need to wake it up:
+			std::atomic<bool> _spinning;
+
+			// The maximum time to spin, and the current time to spin which adapts to how long the loop blocks for:
+			TimeT _busy_poll, _spin_budget;
+
+			/// Spin until there are notifications or file descriptor events, or the spin budget is used up.
+			/// @returns true if there is work to do.
+			bool spin (TimeT timeout);
+
+			/// Adjust the spin budget after waiting, based on whether spinning for longer would have avoided blocking.
+			void adapt_spin_budget (bool spun, bool found);
+
 			Stopwatch _stopwatch;
 
+			// The time each iteration can spend processing timers and notifications, or 0 if there is no limit:
+			TimeT _time_budget;
+
+			// The time spent processing timers and notifications during the current iteration:
+			TimeT _time_used;
+
+			// Moving averages of the time taken to process one timer, one notification, and the ready file descriptors, which are used to divide the time budget:
+			TimeT _timer_cost, _notification_cost, _file_descriptors_cost;
+
+			/// The time remaining in the current iteration for timers and notifications, after setting aside the time file descriptors are expected to take (at most half of the budget).
+			TimeT available_time () const;
+
+			struct Budget;
+
 		public:
-			Loop ();
+			/// The monitor type selects the mechanism used to wait for file descriptor events. By default, the most efficient mechanism for the platform is used.
+			Loop (MonitorType monitor_type = SYSTEM_MONITOR);
 			~Loop ();
 
 		protected:
 			bool _stop_when_idle;
-			unsigned _rate_limit;
+			TimeT _timer_slack;
 
 			/// Runs one iteration of the loop.
 			/// If user_timer_timeout is true, then the timeout is set to the value returned by process_timers() otherwise, the timeout supplied is used.
 			/// @sa run_until_timeout()
 			/// @sa IMonitor::wait_for_events
 			void run_one_iteration (bool use_timer_timeout, TimeT timeout = 0);
+
+			struct Iteration;
 		public:
 			/// Set whether once there are no longer IO or Timer sources, the runloop will stop automatically.
 			void set_stop_when_idle (bool stop_when_idle = true);
 
-			/// Sets whether or not timers and notifications can stall the loop. If a timer constantly schedules itself in the past, it will be called repeatedly and possibly stall other timers and event notification sources. The same goes for notifications - if a notification reschedules itself repeatedly. If you rate limit (which is the default) these types of situations will not cause the loop to stall. This function should generally be used to ensure a robust loop i.e. events are processed promptly.
-			void set_rate_limit (unsigned rate = 10);
+			/// Sets how long each iteration can spend processing timers and notifications, so that they can't stall the loop, e.g. a timer which constantly schedules itself in the past, or a notification which posts itself repeatedly. The time file descriptors have recently taken to dispatch is set aside, up to half of the budget, and the remainder is shared between timers and notifications: timers can use half of it while notifications are waiting, and notifications can use whatever timers didn't. At least one timer and one notification is processed each time, and the remainder is left in place for the next iteration. The default is 5ms. A budget of 0 disables the limit. This function is NOT thread-safe.
+			void set_time_budget (TimeT budget);
+
+			/// Select the data structure used to store timers. The default is TIMER_HEAP, but a timing wheel scales better for large numbers of timers, e.g. connection timeouts. Existing timers are moved. This function is NOT thread-safe.
+			void set_timer_queue (TimerQueueType type);
+
+			/// Allow timers to fire up to the given number of seconds late, so that timers with nearby timeouts are processed together with one wakeup. Wakeups are aligned to multiples of the slack, and timers never fire early. The default is 0, i.e. every timer fires at its exact timeout. This function is NOT thread-safe.
+			void set_timer_slack (TimeT slack);
+
+			/// Spin for up to the given duration before blocking, checking for notifications and polling file descriptors without blocking, to avoid the latency of being woken up. While the loop is spinning, urgent notifications don't write to the notification pipe. The time spent spinning adapts between 0 and the maximum: it grows while events arrive within the maximum, and shrinks while they don't. Spinning uses a CPU core, so it is only suitable for dedicated loop threads. The default is 0, i.e. don't spin. This function is NOT thread-safe.
+			void set_busy_poll (TimeT maximum);
 
 			/// This stopwatch is not thread-safe.
 			const Stopwatch & stopwatch () const;
 
-			/// Schedule a timer for periodic events. This function is thread-safe. If called from a spearate thread, the timer is added by sending an asynchronous notification. The timer will be run on the same thread as the loop, not the calling thread.
-			void schedule_timer (Ref<ITimerSource> source);
+			/// What the loop is doing right now. This can be read from any thread, e.g. by a Watchdog.
+			const LoopActivity & activity () const { return _activity; }
+
+			/// Statistics about the behaviour of the loop. They are always recorded, and can be read from any thread without blocking the loop.
+			const LoopMetrics & metrics () const { return _metrics; }
+
+			/// Record the activity of the loop into the given trace, or stop tracing if it is null. This function is NOT thread-safe.
+			void set_trace (Ref<Trace> trace);
+
+			/// The current trace, if any. It remains valid for the lifetime of the loop, even if it is replaced. This function is thread-safe.
+			Ptr<Trace> trace () const { return _published_trace.load(std::memory_order_acquire); }
+
+			/// Whether the calling thread is the thread which runs the loop. Functions which are not thread-safe must only be called when this is true. This function is thread-safe.
+			bool on_loop_thread () const;
+
+			/// An estimate of the work assigned to the loop: the number of monitored file descriptors, timers and fetched notifications. It is updated by the loop thread each time notifications are processed. This function is thread-safe.
+			std::size_t load () const;
 
-			/// This function performs a notification as soon as possible. This function is thread-safe. If called from a separate thread, it may block while it locks the notification queue. Also, it is okay for a notification to schedule another notification, but it possibly won't run until the next execution of the loop (with the current implementation, this is true in about 50% of cases as notifications are processed twice each run through the loop).
+			/// Schedule a timer for periodic events. This function is thread-safe. If called from a spearate thread, the timer is added by sending an asynchronous notification. The timer will be run on the same thread as the loop, not the calling thread.
+			/// @returns a handle which can be used to cancel or reschedule the timer. If called from a separate thread, the handle is reserved before the timer is added, so it can be used immediately. Cancelling or rescheduling it from a separate thread is applied after the timer is added, and cancelling it from the loop thread prevents it from being added.
+			TimerHandle schedule_timer (Ref<ITimerSource> source);
+
+			/// Schedule a range of timers, e.g. from a std::vector<Ref<TimerSource>>. This function is thread-safe. If called from a separate thread, all the timers are added by sending a single urgent notification. Use schedule_timer() if the handles are required.
+			template <typename IteratorT>
+			void schedule_timers (IteratorT begin, IteratorT end)
+			{
+				schedule_timer_batch(std::vector<Ref<ITimerSource>>(begin, end));
+			}
+
+			/// Remove a timer from the loop immediately, releasing its source. The same as TimerSource::cancel(), but using the handle. This function is thread-safe. If called from a separate thread, the timer is removed by sending an urgent notification.
+			/// @returns false if the handle is no longer valid. Always returns true if called from a separate thread.
+			bool cancel_timer (TimerHandle handle);
+
+			/// Change the time at which a timer is next due to the given duration from now, e.g. to extend an idle timeout. This function is thread-safe. If called from a separate thread, the timer is rescheduled by sending an urgent notification.
+			/// @returns false if the handle is no longer valid. Always returns true if called from a separate thread.
+			bool reschedule_timer (TimerHandle handle, TimeT timeout);
+
+			/// Invoke a function with the signature void(Loop *) on the loop thread. Small callables are stored inline in pooled queue nodes, so posting from a separate thread doesn't allocate. As with post_notification(), if called from the loop thread, the function is invoked immediately. This function is thread-safe.
+			template <typename FunctionT>
+			void post (FunctionT && function)
+			{
+				post_function(std::forward<FunctionT>(function), false);
+			}
+
+			/// As per post(), but the loop is woken up to invoke the function as soon as possible.
+			template <typename FunctionT>
+			void post_urgent (FunctionT && function)
+			{
+				post_function(std::forward<FunctionT>(function), true);
+			}
+
+			/// As per post(), but the function is processed in order of priority and deadline, see post_notification(note, priority, deadline).
+			template <typename FunctionT>
+			void post (FunctionT && function, NotificationPriority priority, TimeT deadline = -1)
+			{
+				post_function(std::forward<FunctionT>(function), priority == HIGH_PRIORITY || deadline >= 0, priority, deadline);
+			}
+
+			/// As per post_urgent(), but the function is always queued, even if called from the loop thread, in which case it is invoked after the caller returns, e.g. so that a callback isn't re-entered. The loop is only woken up if called from a separate thread. This function is thread-safe.
+			template <typename FunctionT>
+			void defer (FunctionT && function)
+			{
+				enqueue_function(std::forward<FunctionT>(function), std::this_thread::get_id() != _current_thread);
+			}
+
+			/// Invoke a function with the signature ResultT(Loop *) on this loop, and deliver the result to a continuation on another loop, e.g. loop->invoke(function).then(continuation). No thread is blocked while waiting for the result. This function is thread-safe.
+			template <typename FunctionT>
+			Future<typename std::decay<FunctionT>::type> invoke (FunctionT && function);
+
+			/// The loop which is running on the current thread, or null if there isn't one.
+			static Loop * current ();
+
+			/// This function performs a notification as soon as possible. This function is thread-safe. If called from a separate thread, the notification is added to a lock-free queue, so it doesn't block. Also, it is okay for a notification to schedule another notification, but it possibly won't run until the next execution of the loop (with the current implementation, this is true in about 50% of cases as notifications are processed twice each run through the loop).
 			void post_notification (Ref<INotificationSource> note, bool urgent = false);
 
-			/// Monitor a file descriptor and process any read/write events when it is possible to do so. This function is NOT thread-safe. For thread-safe monitoring, use a notification.
+			/// As per post_notification(), but the notification is processed in order of priority and, within a priority, earliest deadline first, before any notifications without a deadline. The deadline is the time from now in seconds by which the notification should be processed, or -1 if it doesn't have one. Notifications processed after their deadline are counted by LoopMetrics::notifications_late. High priority notifications and notifications with a deadline wake the loop. This function is thread-safe.
+			void post_notification (Ref<INotificationSource> note, NotificationPriority priority, TimeT deadline = -1);
+
+			/// Post a range of notifications, e.g. from a std::vector<Ref<INotificationSource>>, which are processed in order. This function is thread-safe. If called from a separate thread, the notifications are added to the queue with a single atomic operation, and the loop is woken up at most once if urgent. As per post_notification(), if called from the loop thread, the notifications are processed immediately.
+			template <typename IteratorT>
+			void post_notifications (IteratorT begin, IteratorT end, bool urgent = false)
+			{
+				if (std::this_thread::get_id() == _current_thread) {
+					for (; begin != end; ++begin)
+						(*begin)->process_events(this, NOTIFICATION);
+				} else {
+					Notifications::Node * first = nullptr, * last = nullptr;
+
+					for (; begin != end; ++begin) {
+						Notifications::Node * node = Notifications::allocate();
+						node->source = *begin;
+
+						// The list is linked most recently posted first:
+						node->next = first;
+						first = node;
+
+						if (last == nullptr)
+							last = node;
+					}
+
+					if (first)
+						post_nodes(first, last, urgent);
+				}
+			}
+
+			/// Monitor a file descriptor and process any read/write events when it is possible to do so. The events are derived from the access mode of the file descriptor, see monitor(source, events) to specify them explicitly. This function is NOT thread-safe. For thread-safe monitoring, use a notification.
 			void monitor (Ptr<IFileDescriptorSource> source);
 
+			/// Monitor a file descriptor for specific events, e.g. READ_READY or READ_READY|WRITE_READY. This function is NOT thread-safe.
+			void monitor (Ptr<IFileDescriptorSource> source, int events);
+
+			/// Change the events a monitored file descriptor is interested in. Typically, a source is only interested in WRITE_READY while it has buffered data to write, otherwise the loop would wake up continuously. This is cheap enough to call every time the buffer is flushed. This function is NOT thread-safe.
+			void set_interest (Ptr<IFileDescriptorSource> source, int events);
+
 			/// Stop monitoring a file descriptor. This function is NOT thread-safe.
 			void stop_monitoring_file_descriptor (Ptr<IFileDescriptorSource> source);
 
@@ -138,5 +461,126 @@ namespace Dream
 			/// Run the loop until a specific deadline. This function is fairly strict, and in the general case should return within the timeout specified. This function is designed to be used within other run-loops. This function is only valid when timeout is greater than 0. For timeouts less than or equal to 0, see run_once() or run_forever(). If you supply a timeout <= 0, an exception will be thrown. The function will process the loop until the specified timeout has been reached. If the loop stops, it will return prematurely, and the result will be the remaining time.
 			TimeT run_until_timeout (TimeT timeout);
 		};
+
+		/// The default failure handler of Future::then(), which rethrows the exception on the loop of the continuation.
+		struct RethrowFailure {
+			void operator() (Loop *, std::exception_ptr error) const
+			{
+				std::rethrow_exception(error);
+			}
+		};
+
+		/// The result of Loop::invoke(), which is delivered to a continuation. The function is sent to the target loop when a continuation is attached (or when it is awaited by a coroutine), so the request and the result each cost a single notification using Loop::post_urgent(), without a shared state. If the future is discarded without a continuation, the function is sent when the future is destroyed, as if by Loop::defer(), so it is never invoked by the destructor itself, even on the target loop. Futures can be moved but not copied.
+		template <typename FunctionT>
+		class Future {
+		public:
+			typedef decltype(std::declval<FunctionT &>()(std::declval<Loop *>())) ResultT;
+
+		protected:
+			Ref<Loop> _target;
+			FunctionT _function;
+
+			// Whether the function still needs to be sent to the target loop:
+			bool _pending;
+
+			template <typename ValueT, typename Dummy = void>
+			struct Reply {
+				template <typename ContinuationT, typename FailureT>
+				static void invoke (Loop * target, FunctionT & function, Ref<Loop> & loop, ContinuationT & continuation, FailureT & failure)
+				{
+					try {
+						ValueT result = function(target);
+
+						loop->post_urgent([continuation, result](Loop * loop) mutable {
+							continuation(loop, std::move(result));
+						});
+					} catch (...) {
+						Reply<void>::fail(loop, failure, std::current_exception());
+					}
+				}
+			};
+
+			template <typename Dummy>
+			struct Reply<void, Dummy> {
+				template <typename ContinuationT, typename FailureT>
+				static void invoke (Loop * target, FunctionT & function, Ref<Loop> & loop, ContinuationT & continuation, FailureT & failure)
+				{
+					try {
+						function(target);
+
+						loop->post_urgent([continuation](Loop * loop) mutable {
+							continuation(loop);
+						});
+					} catch (...) {
+						fail(loop, failure, std::current_exception());
+					}
+				}
+
+				template <typename FailureT>
+				static void fail (Ref<Loop> & loop, FailureT & failure, std::exception_ptr error)
+				{
+					loop->post_urgent([failure, error](Loop * loop) mutable {
+						failure(loop, error);
+					});
+				}
+			};
+
+		public:
+			Future (Ref<Loop> target, FunctionT function) : _target(target), _function(std::move(function)), _pending(true)
+			{
+			}
+
+			Future (Future && other) : _target(other._target), _function(std::move(other._function)), _pending(other._pending)
+			{
+				other._pending = false;
+			}
+
+			Future (const Future &) = delete;
+			Future & operator= (const Future &) = delete;
+
+			~Future ()
+			{
+				if (_pending)
+					_target->defer(std::move(_function));
+			}
+
+			Ref<Loop> target () const { return _target; }
+
+			/// Send the function to the target loop, and invoke the continuation on the given loop with the result, i.e. continuation(loop, result), or continuation(loop) if the function doesn't return a value. If the function throws an exception, it is caught on the target loop and failure(loop, exception) is invoked on the given loop instead of the continuation.
+			template <typename ContinuationT, typename FailureT>
+			void then (Ref<Loop> loop, ContinuationT continuation, FailureT failure)
+			{
+				DREAM_ASSERT(loop);
+				DREAM_ASSERT(_pending);
+
+				_pending = false;
+
+				FunctionT function = std::move(_function);
+
+				_target->post_urgent([function, loop, continuation, failure](Loop * target) mutable {
+					Reply<ResultT>::invoke(target, function, loop, continuation, failure);
+				});
+			}
+
+			/// Invoke the continuation on the given loop. If the function throws an exception, it is rethrown on the given loop rather than on the target loop.
+			template <typename ContinuationT>
+			void then (Ref<Loop> loop, ContinuationT continuation)
+			{
+				then(loop, std::move(continuation), RethrowFailure());
+			}
+
+			/// Invoke the continuation on the loop of the current thread.
+			template <typename ContinuationT>
+			void then (ContinuationT continuation)
+			{
+				then(Loop::current(), std::move(continuation));
+			}
+		};
+
+		template <typename FunctionT>
+		Future<typename std::decay<FunctionT>::type> Loop::invoke (FunctionT && function)
+		{
+			return Future<typename std::decay<FunctionT>::type>(this, std::forward<FunctionT>(function));
+		}
 	}
 }
@@ -0,0 +1,191 @@
+//
+//  Metrics.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <signal.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+// MARK: -
+// MARK: class Histogram
+
+		CPUSet::CPUSet ()
+		{
+			for (std::size_t i = 0; i < WORDS; i += 1)
+				_words[i].store(0, std::memory_order_relaxed);
+		}
+
+		void CPUSet::assign (const std::vector<unsigned> & cpus)
+		{
+			std::uint64_t words[WORDS] = {};
+
+			for (auto cpu : cpus) {
+				if (cpu < MAXIMUM)
+					words[cpu / 64] |= std::uint64_t(1) << (cpu % 64);
+			}
+
+			for (std::size_t i = 0; i < WORDS; i += 1)
+				_words[i].store(words[i], std::memory_order_relaxed);
+		}
+
+		bool CPUSet::contains (unsigned cpu) const
+		{
+			if (cpu >= MAXIMUM)
+				return false;
+
+			return (_words[cpu / 64].load(std::memory_order_relaxed) >> (cpu % 64)) & 1;
+		}
+
+		std::vector<unsigned> CPUSet::cpus () const
+		{
+			std::vector<unsigned> cpus;
+
+			for (std::size_t i = 0; i < WORDS; i += 1) {
+				std::uint64_t word = _words[i].load(std::memory_order_relaxed);
+
+				for (unsigned bit = 0; word; bit += 1, word >>= 1) {
+					if (word & 1)
+						cpus.push_back(i * 64 + bit);
+				}
+			}
+
+			return cpus;
+		}
+
+		Histogram::Histogram () : _maximum(0)
+		{
+			for (auto & count : _counts)
+				count.store(0, std::memory_order_relaxed);
+		}
+
+		std::size_t Histogram::index (std::uint64_t value)
+		{
+			if (value < SUB_BUCKETS)
+				return value;
+
+			// The position of the most significant bit selects the bucket, and the following PRECISION bits select the sub-bucket:
+			unsigned exponent = 63 - __builtin_clzll(value);
+			std::size_t sub_bucket = (value >> (exponent - PRECISION)) & (SUB_BUCKETS - 1);
+
+			return SUB_BUCKETS + (exponent - PRECISION) * SUB_BUCKETS + sub_bucket;
+		}
+
+		std::uint64_t Histogram::upper_bound (std::size_t index)
+		{
+			if (index < SUB_BUCKETS)
+				return index;
+
+			unsigned shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+			std::uint64_t sub_bucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+			return ((SUB_BUCKETS + sub_bucket) << shift) + ((std::uint64_t(1) << shift) - 1);
+		}
+
+		std::uint64_t Histogram::count () const
+		{
+			std::uint64_t count = 0;
+
+			for (auto & bucket : _counts)
+				count += bucket.load(std::memory_order_relaxed);
+
+			return count;
+		}
+
+		double Histogram::mean () const
+		{
+			std::uint64_t count = this->count();
+
+			return count ? double(total()) / count : 0;
+		}
+
+		std::uint64_t Histogram::percentile (double percentage) const
+		{
+			// The buckets are read once, as they may be updated concurrently:
+			std::uint64_t counts[BUCKETS], count = 0;
+
+			for (std::size_t i = 0; i < BUCKETS; i += 1) {
+				counts[i] = _counts[i].load(std::memory_order_relaxed);
+				count += counts[i];
+			}
+
+			if (count == 0)
+				return 0;
+
+			std::uint64_t rank = std::max<std::uint64_t>(1, std::ceil(count * std::min(percentage, 100.0) / 100.0));
+			std::uint64_t seen = 0;
+
+			for (std::size_t i = 0; i < BUCKETS; i += 1) {
+				seen += counts[i];
+
+				if (seen >= rank)
+					return std::min(upper_bound(i), maximum());
+			}
+
+			return maximum();
+		}
+
+		std::ostream & operator<< (std::ostream & output, const Histogram & histogram)
+		{
+			output << "count=" << histogram.count() << " mean=" << histogram.mean() << " p50=" << histogram.percentile(50) << " p99=" << histogram.percentile(99) << " p999=" << histogram.percentile(99.9) << " max=" << histogram.maximum();
+
+			return output;
+		}
+
+		bool LoopActivity::interrupt (std::uint64_t heartbeat, int signal) const
+		{
+			// This is sequentially consistent with respect to the state, so either the loop is seen to have finished the iteration, or it waits for the signal to be sent:
+			interrupting.fetch_add(1);
+
+			bool sent = false;
+
+			if (state.load() == RUNNING && this->heartbeat.load(std::memory_order_relaxed) == heartbeat)
+				sent = pthread_kill(thread.load(std::memory_order_relaxed), signal) == 0;
+
+			interrupting.fetch_sub(1);
+
+			return sent;
+		}
+
+		std::ostream & operator<< (std::ostream & output, const LoopMetrics & metrics)
+		{
+			output << "iterations: " << metrics.iterations.value() << std::endl;
+			output << "blocked time (ns): " << metrics.blocked_time.value() << std::endl;
+			output << "busy time (ns): " << metrics.busy_time.value() << std::endl;
+			output << "timers time (ns): " << metrics.timers_time << std::endl;
+			output << "notifications time (ns): " << metrics.notifications_time << std::endl;
+			output << "file descriptors time (ns): " << metrics.file_descriptors_time << std::endl;
+			output << "timer lateness (ns): " << metrics.timer_lateness << std::endl;
+			output << "notification depth: " << metrics.notification_depth << std::endl;
+			output << "ready file descriptors: " << metrics.ready_file_descriptors << std::endl;
+			output << "timers deferred: " << metrics.timers_deferred.value() << std::endl;
+			output << "notifications deferred: " << metrics.notifications_deferred.value() << std::endl;
+			output << "notifications late: " << metrics.notifications_late.value() << std::endl;
+			output << "spins: " << metrics.spins.value() << " (" << metrics.spin_hits.value() << " hits)" << std::endl;
+
+			std::vector<unsigned> affinity = metrics.affinity.cpus();
+			output << "affinity:";
+
+			if (affinity.empty())
+				output << " any";
+
+			for (auto cpu : affinity)
+				output << " " << cpu;
+
+			output << std::endl;
+
+			return output;
+		}
+	}
+}
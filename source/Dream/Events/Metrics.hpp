@@ -0,0 +1,202 @@
+//
+//  Metrics.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Events.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <typeinfo>
+#include <vector>
+
+#include <pthread.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Convert a duration to nanoseconds, as recorded by metrics. Negative durations are recorded as 0.
+		inline std::uint64_t nanoseconds (TimeT duration)
+		{
+			return duration > 0 ? std::uint64_t(duration * 1e9) : 0;
+		}
+
+		/// A counter which is updated by a single thread and can be read by any thread. Updates don't use atomic read-modify-write instructions.
+		class Counter {
+		protected:
+			std::atomic<std::uint64_t> _value;
+
+		public:
+			Counter () : _value(0) {}
+
+			Counter (const Counter &) = delete;
+			Counter & operator= (const Counter &) = delete;
+
+			void add (std::uint64_t amount = 1)
+			{
+				_value.store(_value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+			}
+
+			std::uint64_t value () const
+			{
+				return _value.load(std::memory_order_relaxed);
+			}
+		};
+
+		/// A histogram of non-negative integers, which is updated by a single thread and can be read by any thread without blocking it. Values are counted in logarithmic buckets which are each split into linear sub-buckets (as in HDR histograms), so the range is unlimited and percentiles are accurate to within 1/SUB_BUCKETS of the value. Recording a value is a few instructions and never allocates.
+		class Histogram {
+		public:
+			static const unsigned PRECISION = 4;
+			static const std::size_t SUB_BUCKETS = 1 << PRECISION;
+			static const std::size_t BUCKETS = SUB_BUCKETS + (64 - PRECISION) * SUB_BUCKETS;
+
+		protected:
+			std::atomic<std::uint64_t> _counts[BUCKETS];
+			Counter _total;
+			std::atomic<std::uint64_t> _maximum;
+
+			static std::size_t index (std::uint64_t value);
+
+			/// The largest value which is counted in the given bucket.
+			static std::uint64_t upper_bound (std::size_t index);
+
+		public:
+			Histogram ();
+
+			Histogram (const Histogram &) = delete;
+			Histogram & operator= (const Histogram &) = delete;
+
+			void record (std::uint64_t value)
+			{
+				std::atomic<std::uint64_t> & count = _counts[index(value)];
+				count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+				_total.add(value);
+
+				if (value > _maximum.load(std::memory_order_relaxed))
+					_maximum.store(value, std::memory_order_relaxed);
+			}
+
+			/// The number of values recorded.
+			std::uint64_t count () const;
+
+			/// The sum of all values recorded.
+			std::uint64_t total () const { return _total.value(); }
+
+			std::uint64_t maximum () const { return _maximum.load(std::memory_order_relaxed); }
+
+			double mean () const;
+
+			/// The value which the given percentage of values (0 to 100) are less than or equal to, e.g. percentile(99). Returns 0 if no values have been recorded.
+			std::uint64_t percentile (double percentage) const;
+		};
+
+		/// A set of CPUs, which is updated by a single thread and can be read by any thread. It covers the same range of CPUs as cpu_set_t on Linux.
+		class CPUSet {
+		public:
+			static const std::size_t MAXIMUM = 1024;
+
+		protected:
+			static const std::size_t WORDS = MAXIMUM / 64;
+
+			std::atomic<std::uint64_t> _words[WORDS];
+
+		public:
+			CPUSet ();
+
+			CPUSet (const CPUSet &) = delete;
+			CPUSet & operator= (const CPUSet &) = delete;
+
+			/// Replace the set with the given CPUs. CPUs which are MAXIMUM or more are ignored.
+			void assign (const std::vector<unsigned> & cpus);
+
+			bool contains (unsigned cpu) const;
+
+			/// The CPUs in the set, in ascending order.
+			std::vector<unsigned> cpus () const;
+		};
+
+		/// Statistics about the behaviour of a loop, which are recorded by the loop thread and can be read by any thread without blocking it. Durations are in nanoseconds.
+		struct LoopMetrics {
+			/// The number of times the loop has run through an iteration.
+			Counter iterations;
+
+			/// The total time the loop was blocked waiting for events, and the total time it was processing events.
+			Counter blocked_time, busy_time;
+
+			/// The time taken by each call to process timers, notifications and file descriptors (including the time blocked waiting for events).
+			Histogram timers_time, notifications_time, file_descriptors_time;
+
+			/// How long after its timeout each timer was processed.
+			Histogram timer_lateness;
+
+			/// The number of notifications fetched from the queue at a time.
+			Histogram notification_depth;
+
+			/// The number of file descriptors which were ready each time the loop waited for events.
+			Histogram ready_file_descriptors;
+
+			/// The number of times processing was deferred to the next iteration because the time budget was used up.
+			Counter timers_deferred, notifications_deferred;
+
+			/// The number of notifications which were processed after their deadline.
+			Counter notifications_late;
+
+			/// The number of times the loop spun before blocking, and how many times work arrived while it was spinning.
+			Counter spins, spin_hits;
+
+			/// The CPUs the loop thread has been pinned to, or empty if it hasn't been pinned. Set by Thread when it starts.
+			CPUSet affinity;
+		};
+
+		/// What a loop is doing right now, which is updated by the loop thread and can be read by any thread, e.g. to detect a loop which has stalled. The fields are updated independently, so they may be momentarily inconsistent.
+		struct LoopActivity {
+			enum State {
+				/// The loop isn't running.
+				IDLE = 0,
+				/// The loop is processing timers, notifications or file descriptors.
+				RUNNING = 1,
+				/// The loop is waiting for file descriptor events.
+				WAITING = 2
+			};
+
+			/// Incremented every time the loop starts an iteration or processes a source. If it doesn't change while the loop is running, the loop is stuck.
+			std::atomic<std::uint64_t> heartbeat;
+
+			std::atomic<int> state;
+
+			/// The type of the source being processed, or null.
+			std::atomic<const std::type_info *> source;
+			std::atomic<FileDescriptor> file_descriptor;
+
+			/// The thread which is running the loop.
+			std::atomic<pthread_t> thread;
+
+			/// The number of threads which are about to signal the loop thread. The loop thread doesn't finish an iteration while this is non-zero, so that it can't exit before it's signalled.
+			mutable std::atomic<int> interrupting;
+
+			LoopActivity () : heartbeat(0), state(IDLE), source(nullptr), file_descriptor(-1), thread(pthread_t()), interrupting(0) {}
+
+			/// Send a signal to the loop thread, if it is still running the iteration with the given heartbeat. This function is thread-safe.
+			/// @returns whether the signal was sent.
+			bool interrupt (std::uint64_t heartbeat, int signal) const;
+
+			void beat ()
+			{
+				heartbeat.store(heartbeat.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		};
+
+		std::ostream & operator<< (std::ostream & output, const Histogram & histogram);
+
+		/// Write a summary of the metrics, one line for each statistic.
+		std::ostream & operator<< (std::ostream & output, const LoopMetrics & metrics);
+	}
+}
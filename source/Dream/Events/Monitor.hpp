@@ -21,18 +21,32 @@ namespace Dream
 		class FileDescriptorClosed {
 		};
 
+		/// Selects the operating system level event-handling mechanism used by a Loop. If the requested mechanism isn't available on the current platform, the loop falls back to SYSTEM_MONITOR.
+		enum MonitorType {
+			/// The most efficient mechanism available, i.e. epoll on Linux and kqueue on BSD/Mac OS X.
+			SYSTEM_MONITOR = 0,
+			POLL_MONITOR = 1,
+			EPOLL_MONITOR = 2,
+			KQUEUE_MONITOR = 3,
+			/// Uses io_uring on Linux where supported by the kernel, otherwise falls back to SYSTEM_MONITOR.
+			IO_URING_MONITOR = 4
+		};
+
 		/// An interface for various operating system level event-handling mechanisms, e.g. kqueue, poll.
 		class IMonitor : virtual public IObject {
 		public:
 			IMonitor();
 			virtual ~IMonitor();
 			
-			/// Remove a source to be monitored
-			virtual void add_source (Ptr<IFileDescriptorSource> source) = 0;
+			/// Add a source to be monitored for the given events, e.g. READ_READY|WRITE_READY.
+			virtual void add_source (Ptr<IFileDescriptorSource> source, int events) = 0;
 
-			/// Add a source to be monitored
+			/// Remove a source to be monitored
 			virtual void remove_source (Ptr<IFileDescriptorSource> source) = 0;
 
+			/// Change the events a source is monitored for. This is called frequently (e.g. to enable WRITE_READY only while there is data to write), so implementations should make it cheap, e.g. by deferring system calls until the next wait.
+			virtual void set_interest (Ptr<IFileDescriptorSource> source, int events) = 0;
+
 			/// Count of active file descriptors
 			virtual std::size_t source_count () const = 0;
 
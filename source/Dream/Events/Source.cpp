@@ -16,6 +16,10 @@
 
 #include <unistd.h>
 
+#if defined(TARGET_OS_LINUX)
+	#include <sys/eventfd.h>
+#endif
+
 #include <Dream/Core/Logger.hpp>
 
 namespace Dream
@@ -52,7 +56,7 @@ namespace Dream
 // MARK: -
 // MARK: class TimerSource
 
-		TimerSource::TimerSource (CallbackT callback, TimeT duration, bool repeats, bool strict) : _cancelled(false), _repeats(repeats), _strict(strict), _duration(duration), _callback(callback)
+		TimerSource::TimerSource (CallbackT callback, TimeT duration, bool repeats, bool strict) : _cancelled(false), _repeats(repeats), _strict(strict), _duration(duration), _callback(callback), _loop(nullptr)
 		{
 		}
 
@@ -87,9 +91,40 @@ namespace Dream
 				return last_timeout + _duration;
 		}
 
+		void TimerSource::scheduled (Loop * loop, const TimerHandle & handle)
+		{
+			if (loop) {
+				_loop = loop;
+				_handle = handle;
+
+				// The timer was cancelled before it was added to the loop:
+				if (_cancelled)
+					loop->cancel_timer(handle);
+			} else if (handle == _handle) {
+				_loop = nullptr;
+			}
+		}
+
 		void TimerSource::cancel ()
 		{
+			// This is sequentially consistent with respect to the loop, so either the timer is removed here, or scheduled() sees that it was cancelled:
 			_cancelled = true;
+
+			Loop * loop = _loop;
+
+			if (loop == nullptr)
+				return;
+
+			if (loop->on_loop_thread()) {
+				loop->cancel_timer(_handle);
+			} else {
+				// The handle belongs to the loop thread, so the timer is removed there:
+				Ref<TimerSource> source(this);
+
+				loop->post_urgent([source](Loop *) {
+					source->cancel();
+				});
+			}
 		}
 
 // MARK: -
@@ -182,17 +217,25 @@ namespace Dream
 // MARK: -
 // MARK: class NotificationPipeSource
 
-		NotificationPipeSource::NotificationPipeSource ()
+		NotificationPipeSource::NotificationPipeSource () : _pending(false)
 		{
+#if defined(TARGET_OS_LINUX)
+			_file_descriptors[0] = _file_descriptors[1] = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+
+			DREAM_ASSERT(_file_descriptors[0] != -1);
+#else
 			int result = pipe(_file_descriptors);
 			
 			DREAM_ASSERT(result == 0);
+#endif
 		}
 
 		NotificationPipeSource::~NotificationPipeSource ()
 		{
 			close(_file_descriptors[0]);
-			close(_file_descriptors[1]);
+
+			if (_file_descriptors[1] != _file_descriptors[0])
+				close(_file_descriptors[1]);
 		}
 
 		FileDescriptor NotificationPipeSource::file_descriptor () const
@@ -203,18 +246,37 @@ namespace Dream
 
 		void NotificationPipeSource::notify_event_loop () const
 		{
+			// If the loop has already been notified, it will process this notification too:
+			if (_pending.exchange(true))
+				return;
+
+#if defined(TARGET_OS_LINUX)
+			uint64_t value = 1;
+			write(_file_descriptors[1], &value, sizeof(value));
+#else
 			// Send a byte down the pipe
 			write(_file_descriptors[1], "\0", 1);
+#endif
 		}
 
 		void NotificationPipeSource::process_events (Loop * loop, Event event)
 		{
+#if defined(TARGET_OS_LINUX)
+			uint64_t value;
+
+			// Reset the eventfd counter:
+			read(_file_descriptors[0], &value, sizeof(value));
+#else
 			const std::size_t COUNT = 32;
 			
 			char buffer[COUNT];
 
 			// Discard all notification bytes:
 			read(_file_descriptors[0], &buffer, COUNT);
+#endif
+
+			// Any notification posted after this point will notify the loop again. This must happen before processing, otherwise notifications posted while processing could be missed:
+			_pending.store(false);
 
 			// Process urgent notifications:
 			loop->process_notifications();
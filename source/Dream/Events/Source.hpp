@@ -12,6 +12,8 @@
 #include "Events.hpp"
 
 #include <functional>
+#include <atomic>
+#include <cstdint>
 
 namespace Dream
 {
@@ -47,20 +49,41 @@ namespace Dream
 			static Ref<NotificationSource> stop_loop_notification ();
 		};
 
+		/// Identifies a timer scheduled on a Loop, so that it can be cancelled or rescheduled. A handle becomes invalid once the timer has been cancelled or has stopped repeating, and using it is then a no-op.
+		struct TimerHandle {
+			std::uint32_t index, generation;
+
+			TimerHandle () : index(~std::uint32_t(0)), generation(0) {}
+			TimerHandle (std::uint32_t index_, std::uint32_t generation_) : index(index_), generation(generation_) {}
+
+			explicit operator bool () const { return index != ~std::uint32_t(0); }
+
+			bool operator== (const TimerHandle & other) const { return index == other.index && generation == other.generation; }
+			bool operator!= (const TimerHandle & other) const { return !(*this == other); }
+		};
+
 		class ITimerSource : virtual public ISource {
 		public:
 			virtual bool repeats () const = 0;
 			virtual TimeT next_timeout (const TimeT & last_timeout, const TimeT & current_time) const = 0;
+
+			/// Called on the loop thread with the handle of the timer when it is added to a loop, and with a null loop when it is removed, so that the source can remove itself. The default implementation does nothing.
+			virtual void scheduled (Loop *, const TimerHandle &) {}
 		};
 
 		class TimerSource : public Object, virtual public ITimerSource {
 			typedef std::function<void (Loop *, TimerSource *, Event)> CallbackT;
 
 		protected:
-			bool _cancelled, _repeats, _strict;
+			std::atomic<bool> _cancelled;
+			bool _repeats, _strict;
 			TimeT _duration;
 			CallbackT _callback;
 
+			// The loop which the timer was most recently added to, while it is scheduled. The handle is only used on the loop thread:
+			std::atomic<Loop *> _loop;
+			TimerHandle _handle;
+
 		public:
 			/// A strict timer attempts to fire callbacks even if they are in the past.
 			/// A non-strict timer might drop events.
@@ -72,6 +95,9 @@ namespace Dream
 			virtual bool repeats () const;
 			virtual TimeT next_timeout (const TimeT & last_timeout, const TimeT & current_time) const;
 
+			virtual void scheduled (Loop * loop, const TimerHandle & handle);
+
+			/// Stop the timer from firing and remove it from the loop, so that it no longer causes the loop to wake up. This function is thread-safe: if called from a separate thread, the timer stops firing immediately, and it is removed by the loop thread.
 			void cancel ();
 		};
 
@@ -108,15 +134,21 @@ namespace Dream
 
 		/* Internal class used for processing urgent notifications
 
+		   On Linux, this uses an eventfd, otherwise a pipe. Notifications are coalesced: once the loop has been notified, further calls to notify_event_loop() don't write anything until the loop has processed the pending notifications, so a burst of notifications costs one write and one read.
 		 */
 		class NotificationPipeSource : public Object, virtual public IFileDescriptorSource {
 		protected:
+			// On Linux, both file descriptors refer to the same eventfd.
 			FileDescriptor _file_descriptors[2];
 
+			// Set while the loop has been notified but hasn't read the notification yet.
+			mutable std::atomic<bool> _pending;
+
 		public:
 			NotificationPipeSource ();
 			virtual ~NotificationPipeSource ();
 
+			/// This function is thread-safe.
 			void notify_event_loop () const;
 
 			virtual FileDescriptor file_descriptor () const;
@@ -12,24 +12,38 @@
 
 #include <string.h>
 
+#if defined(TARGET_OS_LINUX)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
 namespace Dream {
 	namespace Events {
 		using namespace Logging;
 		
+		// The GNU version of strerror_r returns the description, which isn't necessarily stored in the buffer:
+		static inline const char * error_description (const char * result, const char * buffer)
+		{
+			return result;
+		}
+
+		// The XSI version of strerror_r returns 0 if the description was stored in the buffer:
+		static inline const char * error_description (int result, const char * buffer)
+		{
+			return result == 0 ? buffer : "Unknown failure";
+		}
+
 		std::string system_error_description(int error_number)
 		{
 			const std::size_t MAX_LENGTH = 1024;
 			char buffer[MAX_LENGTH];
 
-			if (strerror_r(error_number, buffer, MAX_LENGTH) == 0)
-				return buffer;
-			else
-				return "Unknown failure";
+			return error_description(strerror_r(error_number, buffer, MAX_LENGTH), buffer);
 		}
 
-		Thread::Thread ()
+		Thread::Thread (MonitorType monitor_type)
 		{
-			_loop = new Loop;
+			_loop = new Loop(monitor_type);
 			_loop->set_stop_when_idle(false);
 		}
 
@@ -43,6 +57,44 @@ namespace Dream {
 			return _loop;
 		}
 
+		void Thread::set_affinity (std::vector<unsigned> cpus)
+		{
+			DREAM_ASSERT(!_thread);
+
+			_affinity = cpus;
+		}
+
+		/// Restrict the current thread to the given CPUs.
+		/// @returns whether the thread was pinned.
+		static bool apply_affinity (const std::vector<unsigned> & cpus)
+		{
+#if defined(TARGET_OS_LINUX)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+
+			for (auto cpu : cpus) {
+				if (cpu < CPU_SETSIZE)
+					CPU_SET(cpu, &set);
+				else
+					log_warning("Ignoring CPU", cpu, "which is beyond the CPUs supported for thread affinity!");
+			}
+
+			int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+			if (result != 0) {
+				log_warning("Could not set thread affinity:", system_error_description(result));
+
+				return false;
+			}
+
+			return true;
+#else
+			log_warning("Thread affinity is not supported on this platform!");
+
+			return false;
+#endif
+		}
+
 		void Thread::start ()
 		{
 			if (!_thread)
@@ -53,6 +105,10 @@ namespace Dream {
 		{
 			log_debug("-> Starting thread-based event-loop", this);
 
+			// Pin the thread before the loop runs, so that the memory it allocates while running is local:
+			if (!_affinity.empty() && apply_affinity(_affinity))
+				_loop->_metrics.affinity.assign(_affinity);
+
 			// Lock the loop to ensure it isn't released by another thread:
 			Ref<Loop> loop = _loop;
 
@@ -12,6 +12,11 @@
 
 #include <thread>
 #include <mutex>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <iterator>
+#include <algorithm>
 
 namespace Dream
 {
@@ -25,17 +30,25 @@ namespace Dream
 			Ref<Loop> _loop;
 			Shared<std::thread> _thread;
 
+			std::vector<unsigned> _affinity;
+
 			void run ();
 
 		public:
-			Thread ();
+			Thread (MonitorType monitor_type = SYSTEM_MONITOR);
 
-			/// This destructor may block if the event-loop is not responding.
+			/// This destructor may block if the event-loop is not responding. A Watchdog can be used to find out why.
 			~Thread ();
 
 			/// The remote loop instance.
 			Ref<Loop> loop();
 
+			/// Restrict the thread to the given CPUs, e.g. to keep a loop on one core. This must be called before the thread is started. The CPUs are recorded in the loop's metrics once the thread is pinned. Memory which the loop allocates while running, e.g. for sources and notifications, is local to the NUMA node of those CPUs (with the default first-touch policy), but the loop itself is allocated by the thread which constructs the Thread. Not all platforms support thread affinity, in which case a warning is logged.
+			void set_affinity (std::vector<unsigned> cpus);
+
+			/// The CPUs the thread is restricted to, or empty if it may run on any CPU.
+			const std::vector<unsigned> & affinity () const { return _affinity; }
+
 			/// Start the event-loop on a new thread.
 			void start();
 
@@ -110,5 +123,210 @@ namespace Dream
 
 			return _processing;
 		}
+
+		/// Selects whether a RingQueue can be added to by more than one thread at a time.
+		enum QueueProducers {
+			/// Only one thread adds items, so reserving space doesn't need an atomic read-modify-write.
+			SINGLE_PRODUCER = 0,
+			/// Any number of threads can add items.
+			MULTIPLE_PRODUCERS = 1
+		};
+
+		/// Stream data from one or more writers to a single reader through a bounded, lock-free ring buffer. Unlike Queue, items are moved rather than copied, so move-only items are supported, and adding an item fails rather than allocating when the queue is full, so that producers can apply backpressure.
+		template <typename ItemT, QueueProducers PRODUCERS = MULTIPLE_PRODUCERS>
+		class RingQueue : public Object {
+		protected:
+			static const std::size_t CACHE_LINE = 64;
+
+			/// Each cell has a sequence number which tells producers and the consumer whose turn it is: a producer may fill the cell at position p when its sequence is p, and the consumer may take the item when its sequence is p + 1.
+			struct Cell {
+				std::atomic<std::size_t> sequence;
+				typename std::aligned_storage<sizeof(ItemT), alignof(ItemT)>::type storage;
+
+				ItemT * item () { return reinterpret_cast<ItemT *>(&storage); }
+			};
+
+			std::size_t _mask;
+			std::unique_ptr<Cell[]> _cells;
+
+			// The positions are kept on separate cache lines, so that producers and the consumer don't contend:
+			char _padding_before_tail[CACHE_LINE];
+
+			// The next position to be reserved by a producer:
+			std::atomic<std::size_t> _tail;
+
+			char _padding_before_head[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+
+			// The next position to be fetched by the consumer, published after each fetch so that producers can reserve space in batches:
+			std::atomic<std::size_t> _head;
+
+			char _padding_after_head[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+
+			template <typename ValueT>
+			bool push (ValueT && value);
+
+		public:
+			/// The capacity is rounded up to a power of two.
+			RingQueue (std::size_t capacity);
+			virtual ~RingQueue ();
+
+			std::size_t capacity () const { return _mask + 1; }
+
+			/// Add an item if there is space. This function can be called by any number of threads if PRODUCERS is MULTIPLE_PRODUCERS, otherwise only one thread.
+			/// @returns false if the queue is full, in which case the item is not moved.
+			bool try_add (ItemT && item) { return push(std::move(item)); }
+			bool try_add (const ItemT & item) { return push(item); }
+
+			/// Add as many items from the range as there is space for, in order, reserving space for them with a single atomic operation. Items which are added are moved from the range. The iterators must be forward iterators.
+			/// @returns the number of items added, which is less than the size of the range if the queue is full.
+			template <typename IteratorT>
+			std::size_t try_add (IteratorT begin, IteratorT end);
+
+			/// Move up to count items into the given array, in the order they were added. This function must only be called by one thread at a time.
+			/// @returns the number of items fetched, or 0 if the queue is empty.
+			std::size_t fetch (ItemT * items, std::size_t count);
+		};
+
+		template <typename ItemT, QueueProducers PRODUCERS>
+		RingQueue<ItemT, PRODUCERS>::RingQueue (std::size_t capacity) : _mask(1), _tail(0), _head(0)
+		{
+			while (_mask < capacity)
+				_mask <<= 1;
+
+			_cells.reset(new Cell[_mask]);
+
+			for (std::size_t i = 0; i < _mask; i += 1)
+				_cells[i].sequence.store(i, std::memory_order_relaxed);
+
+			_mask -= 1;
+		}
+
+		template <typename ItemT, QueueProducers PRODUCERS>
+		RingQueue<ItemT, PRODUCERS>::~RingQueue ()
+		{
+			std::size_t position = _head.load(std::memory_order_relaxed);
+
+			// Destroy any items which were never fetched:
+			while (true) {
+				Cell & cell = _cells[position & _mask];
+
+				if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+					break;
+
+				cell.item()->~ItemT();
+				position += 1;
+			}
+		}
+
+		template <typename ItemT, QueueProducers PRODUCERS>
+		template <typename ValueT>
+		bool RingQueue<ItemT, PRODUCERS>::push (ValueT && value)
+		{
+			std::size_t position = _tail.load(std::memory_order_relaxed);
+			Cell * cell;
+
+			while (true) {
+				cell = &_cells[position & _mask];
+
+				std::ptrdiff_t difference = std::ptrdiff_t(cell->sequence.load(std::memory_order_acquire) - position);
+
+				if (difference == 0) {
+					if (PRODUCERS == SINGLE_PRODUCER) {
+						_tail.store(position + 1, std::memory_order_relaxed);
+						break;
+					}
+
+					if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				} else if (difference < 0) {
+					// The consumer hasn't fetched the item from the previous time around the ring:
+					return false;
+				} else {
+					// Another producer reserved this position:
+					position = _tail.load(std::memory_order_relaxed);
+				}
+			}
+
+			new(cell->item()) ItemT(std::forward<ValueT>(value));
+			cell->sequence.store(position + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		template <typename ItemT, QueueProducers PRODUCERS>
+		template <typename IteratorT>
+		std::size_t RingQueue<ItemT, PRODUCERS>::try_add (IteratorT begin, IteratorT end)
+		{
+			std::size_t count = std::distance(begin, end);
+			std::size_t position = _tail.load(std::memory_order_relaxed), reserved;
+
+			while (true) {
+				// Every cell before the head has been released by the consumer, so the space up to a whole ring beyond it is free:
+				std::size_t head = _head.load(std::memory_order_acquire);
+
+				// The position is out of date if the consumer has already fetched it:
+				if (std::ptrdiff_t(position - head) < 0) {
+					position = _tail.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				// The head is only published after each batch is fetched, while push() can reuse cells as soon as they are released, so the tail can be more than a whole ring beyond the head, in which case there is no space for a batch yet:
+				std::size_t used = position - head;
+
+				if (used >= capacity())
+					return 0;
+
+				reserved = std::min(count, capacity() - used);
+
+				if (reserved == 0)
+					return 0;
+
+				if (PRODUCERS == SINGLE_PRODUCER) {
+					_tail.store(position + reserved, std::memory_order_relaxed);
+					break;
+				}
+
+				if (_tail.compare_exchange_weak(position, position + reserved, std::memory_order_relaxed))
+					break;
+			}
+
+			for (std::size_t i = 0; i < reserved; i += 1, ++begin) {
+				Cell & cell = _cells[(position + i) & _mask];
+
+				new(cell.item()) ItemT(std::move(*begin));
+				cell.sequence.store(position + i + 1, std::memory_order_release);
+			}
+
+			return reserved;
+		}
+
+		template <typename ItemT, QueueProducers PRODUCERS>
+		std::size_t RingQueue<ItemT, PRODUCERS>::fetch (ItemT * items, std::size_t count)
+		{
+			std::size_t position = _head.load(std::memory_order_relaxed), fetched = 0;
+
+			while (fetched < count) {
+				Cell & cell = _cells[position & _mask];
+
+				// The item hasn't been added yet:
+				if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+					break;
+
+				ItemT * item = cell.item();
+				items[fetched] = std::move(*item);
+				item->~ItemT();
+
+				// Release the cell for the next time around the ring:
+				cell.sequence.store(position + capacity(), std::memory_order_release);
+
+				position += 1;
+				fetched += 1;
+			}
+
+			if (fetched)
+				_head.store(position, std::memory_order_release);
+
+			return fetched;
+		}
 	}
 }
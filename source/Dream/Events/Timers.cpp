@@ -0,0 +1,538 @@
+//
+//  Timers.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Timers.hpp"
+
+namespace Dream
+{
+	namespace Events
+	{
+		static inline unsigned count_trailing_zeros (std::uint64_t value)
+		{
+			return __builtin_ctzll(value);
+		}
+
+		static inline unsigned most_significant_bit (std::uint64_t value)
+		{
+			return 63 - __builtin_clzll(value);
+		}
+
+		static inline std::uint64_t rotate_right (std::uint64_t value, unsigned count)
+		{
+			return (value >> count) | (value << ((64 - count) & 63));
+		}
+
+		TimerQueue::TimerQueue (TimerQueueType type, TimeT resolution) : _type(type), _size(0), _reserved(0), _resolution(resolution), _current_tick(0)
+		{
+			for (unsigned wheel = 0; wheel < WHEELS; wheel += 1)
+				_pending[wheel] = 0;
+
+			for (unsigned slot = 0; slot < WHEELS * WHEEL_SLOTS; slot += 1)
+				_slots[slot] = NONE;
+		}
+
+		TimerQueue::~TimerQueue ()
+		{
+			// The sources may outlive the loop, so they must forget it:
+			for (IndexT index = 0; index < _entries.size(); index += 1) {
+				Entry & entry = _entries[index];
+
+				if (entry.source)
+					entry.source->scheduled(nullptr, TimerHandle(index, entry.generation));
+			}
+		}
+
+		void TimerQueue::set_type (TimerQueueType type, TimeT current_time)
+		{
+			if (type == _type)
+				return;
+
+			_type = type;
+
+			// Remove all entries from the heap and wheel, and place them again:
+			_heap.clear();
+
+			for (unsigned wheel = 0; wheel < WHEELS; wheel += 1)
+				_pending[wheel] = 0;
+
+			for (unsigned slot = 0; slot < WHEELS * WHEEL_SLOTS; slot += 1)
+				_slots[slot] = NONE;
+
+			for (IndexT index = 0; index < _entries.size(); index += 1) {
+				Location location = _entries[index].location;
+
+				if (location == HEAP || location == WHEEL)
+					place(index, current_time);
+			}
+		}
+
+		TimerHandle TimerQueue::reserve ()
+		{
+			std::lock_guard<std::mutex> lock(_reserve_lock);
+
+			if (_free_handles.empty())
+				return TimerHandle(_reserved++, 0);
+
+			TimerHandle handle = _free_handles.back();
+			_free_handles.pop_back();
+
+			return handle;
+		}
+
+		TimerQueue::Entry & TimerQueue::reserved_entry (IndexT index)
+		{
+			// Entries which were reserved on another thread are added when they are first used:
+			while (index >= _entries.size()) {
+				_entries.resize(_entries.size() + 1);
+
+				_entries.back().location = FREE;
+				_entries.back().generation = 0;
+			}
+
+			return _entries[index];
+		}
+
+		bool TimerQueue::reserved (const TimerHandle & handle)
+		{
+			if (handle.index < _entries.size()) {
+				const Entry & entry = _entries[handle.index];
+
+				// Free entries have a newer generation than any handle which was previously issued for them, so a free entry with the same generation has been reserved:
+				return entry.location == FREE && entry.generation == handle.generation;
+			}
+
+			std::lock_guard<std::mutex> lock(_reserve_lock);
+
+			return handle.index < _reserved && handle.generation == 0;
+		}
+
+		void TimerQueue::release (IndexT index)
+		{
+			Ref<ITimerSource> source = _entries[index].source;
+			TimerHandle handle(index, _entries[index].generation);
+
+			_entries[index].source = Ref<ITimerSource>();
+			recycle(index);
+
+			_size -= 1;
+
+			source->scheduled(nullptr, handle);
+		}
+
+		void TimerQueue::recycle (IndexT index)
+		{
+			Entry & entry = _entries[index];
+
+			entry.location = FREE;
+			entry.generation += 1;
+
+			std::lock_guard<std::mutex> lock(_reserve_lock);
+			_free_handles.push_back(TimerHandle(index, entry.generation));
+		}
+
+		void TimerQueue::place (IndexT index, TimeT current_time)
+		{
+			Entry & entry = _entries[index];
+
+			if (_type == TIMER_HEAP || (_type == TIMER_HYBRID && (entry.timeout - current_time) < (WHEEL_SLOTS * _resolution))) {
+				heap_insert(index);
+			} else {
+				// If the wheel is empty, it can skip directly to the current time:
+				if ((_pending[0] | _pending[1] | _pending[2] | _pending[3] | _pending[4] | _pending[5]) == 0) {
+					TickT current_tick = current_tick_for(current_time);
+
+					if (current_tick > _current_tick)
+						_current_tick = current_tick;
+				}
+
+				entry.tick = tick_for(entry.timeout);
+				wheel_insert(index);
+			}
+		}
+
+		void TimerQueue::detach (IndexT index)
+		{
+			Entry & entry = _entries[index];
+
+			if (entry.location == HEAP)
+				heap_remove(index);
+			else if (entry.location == WHEEL)
+				unlink(index);
+
+			entry.location = RUNNING;
+		}
+
+		TimerHandle TimerQueue::insert (TimeT timeout, Ref<ITimerSource> source, TimeT current_time)
+		{
+			TimerHandle handle = reserve();
+
+			insert(handle, timeout, source, current_time);
+
+			return handle;
+		}
+
+		bool TimerQueue::insert (const TimerHandle & handle, TimeT timeout, Ref<ITimerSource> source, TimeT current_time)
+		{
+			Entry & entry = reserved_entry(handle.index);
+
+			DREAM_ASSERT(entry.generation == handle.generation);
+
+			if (entry.location == CANCELLED) {
+				recycle(handle.index);
+
+				return false;
+			}
+
+			DREAM_ASSERT(entry.location == FREE);
+
+			entry.timeout = timeout;
+			entry.source = source;
+
+			_size += 1;
+
+			place(handle.index, current_time);
+
+			return true;
+		}
+
+		bool TimerQueue::valid (const TimerHandle & handle) const
+		{
+			if (handle.index >= _entries.size())
+				return false;
+
+			const Entry & entry = _entries[handle.index];
+
+			return entry.generation == handle.generation && entry.location != FREE && entry.location != CANCELLED;
+		}
+
+		bool TimerQueue::remove (const TimerHandle & handle)
+		{
+			if (!valid(handle)) {
+				// The timer is removed when it is inserted:
+				if (reserved(handle)) {
+					reserved_entry(handle.index).location = CANCELLED;
+
+					return true;
+				}
+
+				return false;
+			}
+
+			detach(handle.index);
+			release(handle.index);
+
+			return true;
+		}
+
+		bool TimerQueue::reschedule (const TimerHandle & handle, TimeT timeout, TimeT current_time)
+		{
+			if (!valid(handle))
+				return false;
+
+			detach(handle.index);
+
+			_entries[handle.index].timeout = timeout;
+			place(handle.index, current_time);
+
+			return true;
+		}
+
+		bool TimerQueue::running (const TimerHandle & handle) const
+		{
+			return valid(handle) && _entries[handle.index].location == RUNNING;
+		}
+
+		void TimerQueue::requeue (const TimerHandle & handle, TimeT timeout, TimeT current_time)
+		{
+			DREAM_ASSERT(running(handle));
+
+			_entries[handle.index].timeout = timeout;
+			place(handle.index, current_time);
+		}
+
+		bool TimerQueue::next_timeout (TimeT & timeout) const
+		{
+			bool found = false;
+
+			if (!_heap.empty()) {
+				timeout = _entries[_heap[0]].timeout;
+				found = true;
+			}
+
+			TickT tick;
+
+			if (!next_tick(tick))
+				return found;
+
+			TimeT wheel_timeout = tick * _resolution;
+
+			if (!found || wheel_timeout < timeout)
+				timeout = wheel_timeout;
+
+			return true;
+		}
+
+		bool TimerQueue::pop (TimeT current_time, TimerHandle & handle, TimeT & timeout, Ref<ITimerSource> & source)
+		{
+			if (_type != TIMER_HEAP)
+				advance(current_tick_for(current_time));
+
+			IndexT index = NONE;
+
+			if (!_heap.empty() && _entries[_heap[0]].timeout <= current_time)
+				index = _heap[0];
+
+			if (index == NONE)
+				return false;
+
+			detach(index);
+
+			Entry & entry = _entries[index];
+
+			handle = TimerHandle(index, entry.generation);
+			timeout = entry.timeout;
+			source = entry.source;
+
+			return true;
+		}
+
+// MARK: -
+// MARK: Binary Heap
+
+		void TimerQueue::heap_set (std::size_t position, IndexT index)
+		{
+			_heap[position] = index;
+			_entries[index].heap_index = position;
+		}
+
+		void TimerQueue::heap_up (std::size_t position)
+		{
+			IndexT index = _heap[position];
+
+			while (position > 0) {
+				std::size_t parent = (position - 1) / 2;
+
+				if (!before(index, _heap[parent]))
+					break;
+
+				heap_set(position, _heap[parent]);
+				position = parent;
+			}
+
+			heap_set(position, index);
+		}
+
+		void TimerQueue::heap_down (std::size_t position)
+		{
+			IndexT index = _heap[position];
+			std::size_t size = _heap.size();
+
+			while (true) {
+				std::size_t child = position * 2 + 1;
+
+				if (child >= size)
+					break;
+
+				if (child + 1 < size && before(_heap[child + 1], _heap[child]))
+					child += 1;
+
+				if (!before(_heap[child], index))
+					break;
+
+				heap_set(position, _heap[child]);
+				position = child;
+			}
+
+			heap_set(position, index);
+		}
+
+		void TimerQueue::heap_insert (IndexT index)
+		{
+			_entries[index].location = HEAP;
+
+			_heap.push_back(index);
+			heap_up(_heap.size() - 1);
+		}
+
+		void TimerQueue::heap_remove (IndexT index)
+		{
+			std::size_t position = _entries[index].heap_index;
+			IndexT last = _heap.back();
+
+			_heap.pop_back();
+
+			if (position < _heap.size()) {
+				heap_set(position, last);
+
+				heap_up(position);
+				heap_down(_entries[last].heap_index);
+			}
+		}
+
+// MARK: -
+// MARK: Hierarchical Timing Wheel
+
+		TimerQueue::TickT TimerQueue::tick_for (TimeT time) const
+		{
+			if (time <= 0)
+				return 0;
+
+			// The smallest tick which is not before the given time. This is computed using the same multiplication as next_timeout, so that the results are consistent.
+			TickT tick = time / _resolution;
+
+			if (tick * _resolution < time)
+				tick += 1;
+
+			return tick;
+		}
+
+		TimerQueue::TickT TimerQueue::current_tick_for (TimeT time) const
+		{
+			TickT tick = tick_for(time);
+
+			if (tick * _resolution > time)
+				tick -= 1;
+
+			return tick;
+		}
+
+		void TimerQueue::link (IndexT index, IndexT & head, std::uint16_t list)
+		{
+			Entry & entry = _entries[index];
+
+			entry.list = list;
+			entry.previous = NONE;
+			entry.next = head;
+
+			if (head != NONE)
+				_entries[head].previous = index;
+
+			head = index;
+		}
+
+		void TimerQueue::unlink (IndexT index)
+		{
+			Entry & entry = _entries[index];
+
+			if (entry.next != NONE)
+				_entries[entry.next].previous = entry.previous;
+
+			if (entry.previous != NONE) {
+				_entries[entry.previous].next = entry.next;
+			} else {
+				_slots[entry.list] = entry.next;
+
+				// Clear the pending bit if the slot is now empty:
+				if (entry.next == NONE)
+					_pending[entry.list / WHEEL_SLOTS] &= ~(std::uint64_t(1) << (entry.list % WHEEL_SLOTS));
+			}
+		}
+
+		void TimerQueue::wheel_insert (IndexT index)
+		{
+			Entry & entry = _entries[index];
+
+			// Entries which are already due are moved to the heap, so that they are popped in order of their timeout:
+			if (entry.tick <= _current_tick) {
+				heap_insert(index);
+
+				return;
+			}
+
+			entry.location = WHEEL;
+
+			TickT delta = entry.tick - _current_tick;
+			TickT tick = entry.tick;
+
+			// Timers beyond the range of the wheel are placed in the last slot, and are placed again when they are cascaded:
+			const TickT RANGE = TickT(1) << (WHEELS * WHEEL_BITS);
+
+			if (delta >= RANGE) {
+				delta = RANGE - 1;
+				tick = _current_tick + delta;
+			}
+
+			// The wheel is selected by the magnitude of the delta, and the slot by the corresponding digit of the tick:
+			unsigned wheel = most_significant_bit(delta) / WHEEL_BITS;
+			unsigned slot = (tick >> (wheel * WHEEL_BITS)) & WHEEL_MASK;
+			unsigned list = wheel * WHEEL_SLOTS + slot;
+
+			link(index, _slots[list], list);
+			_pending[wheel] |= std::uint64_t(1) << slot;
+		}
+
+		bool TimerQueue::next_tick (TickT & tick) const
+		{
+			bool found = false;
+
+			for (unsigned wheel = 0; wheel < WHEELS; wheel += 1) {
+				if (_pending[wheel] == 0)
+					continue;
+
+				unsigned shift = wheel * WHEEL_BITS;
+				TickT position = _current_tick >> shift;
+
+				// Find the first non-empty slot after the current position of this wheel. A slot at the current position was placed one full rotation ahead:
+				unsigned offset = count_trailing_zeros(rotate_right(_pending[wheel], (position + 1) & WHEEL_MASK));
+
+				// For the first wheel, this is the tick at which the slot expires, for the other wheels, it is the tick at which the slot is cascaded into lower wheels:
+				TickT candidate = (position + offset + 1) << shift;
+
+				if (!found || candidate < tick) {
+					tick = candidate;
+					found = true;
+				}
+			}
+
+			return found;
+		}
+
+		void TimerQueue::advance (TickT target)
+		{
+			TickT tick;
+
+			while (next_tick(tick) && tick <= target) {
+				_current_tick = tick;
+
+				// Cascade the slots of the higher wheels which have been reached, starting with the lowest so that entries are not cascaded into a slot which has already been processed:
+				for (unsigned wheel = 1; wheel < WHEELS; wheel += 1) {
+					if (tick & ((TickT(1) << (wheel * WHEEL_BITS)) - 1))
+						break;
+
+					unsigned list = wheel * WHEEL_SLOTS + ((tick >> (wheel * WHEEL_BITS)) & WHEEL_MASK);
+					IndexT index = _slots[list];
+
+					_slots[list] = NONE;
+					_pending[wheel] &= ~(std::uint64_t(1) << (list % WHEEL_SLOTS));
+
+					while (index != NONE) {
+						IndexT next = _entries[index].next;
+						wheel_insert(index);
+						index = next;
+					}
+				}
+
+				// Expire the slot in the first wheel:
+				unsigned list = tick & WHEEL_MASK;
+				IndexT index = _slots[list];
+
+				_slots[list] = NONE;
+				_pending[0] &= ~(std::uint64_t(1) << list);
+
+				while (index != NONE) {
+					IndexT next = _entries[index].next;
+					heap_insert(index);
+					index = next;
+				}
+			}
+
+			if (target > _current_tick)
+				_current_tick = target;
+		}
+	}
+}
@@ -0,0 +1,174 @@
+//
+//  Timers.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Source.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <mutex>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// Selects the data structure used by a Loop to store timers.
+		enum TimerQueueType {
+			/// A binary heap. Scheduling and expiring a timer is O(log n), and timers fire at their exact timeout.
+			TIMER_HEAP = 0,
+			/// A hierarchical timing wheel. Scheduling a timer is O(1), and due timers are moved to the heap so that they fire in order of their timeout, but timeouts are rounded up to the resolution of the wheel. Suitable for large numbers of timers, e.g. idle and keep-alive timeouts.
+			TIMER_WHEEL = 1,
+			/// Timers which are due within the first level of the wheel are stored in the heap so that they fire precisely, all other timers are stored in the wheel.
+			TIMER_HYBRID = 2
+		};
+
+		/// Stores timers ordered by their timeout. This class is used internally by Loop and, except for reserve(), is not thread-safe.
+		class TimerQueue {
+		public:
+			typedef std::uint32_t IndexT;
+			typedef std::uint64_t TickT;
+
+			/// The resolution of the timing wheel, in seconds.
+			TimerQueue (TimerQueueType type = TIMER_HEAP, TimeT resolution = 0.001);
+			~TimerQueue ();
+
+			TimerQueueType type () const { return _type; }
+
+			/// Change the data structure used to store timers. Existing timers are moved.
+			void set_type (TimerQueueType type, TimeT current_time);
+
+			std::size_t size () const { return _size; }
+			bool empty () const { return _size == 0; }
+
+			/// Add a timer which is due at the given timeout.
+			TimerHandle insert (TimeT timeout, Ref<ITimerSource> source, TimeT current_time);
+
+			/// Reserve a handle for a timer which is added later by insert(), e.g. by a notification from a separate thread. This function is thread-safe.
+			TimerHandle reserve ();
+
+			/// Add a timer using a handle from reserve(). If the handle was removed in the mean time, the timer isn't added and the handle is released.
+			/// @returns false if the timer wasn't added.
+			bool insert (const TimerHandle & handle, TimeT timeout, Ref<ITimerSource> source, TimeT current_time);
+
+			/// Whether the handle refers to a timer which is scheduled or being processed.
+			bool valid (const TimerHandle & handle) const;
+
+			/// Remove a timer, releasing its source immediately. O(1) for the wheel and O(log n) for the heap. A reserved handle which hasn't been inserted yet is removed when it is inserted.
+			/// @returns false if the handle is no longer valid.
+			bool remove (const TimerHandle & handle);
+
+			/// Change the timeout of a timer which is scheduled or being processed.
+			/// @returns false if the handle is no longer valid, or is reserved but hasn't been inserted yet.
+			bool reschedule (const TimerHandle & handle, TimeT timeout, TimeT current_time);
+
+			/// The time at which the next timer may be due. For timers stored in the wheel, this may be earlier than the actual timeout.
+			/// @returns false if there are no timers.
+			bool next_timeout (TimeT & timeout) const;
+
+			/// Take a timer which is due at or before the current time out of the queue. Its handle remains valid while it is processed, after which it must be passed to either requeue() or remove(), unless it was rescheduled or removed in the mean time.
+			/// @returns false if there are no timers due.
+			bool pop (TimeT current_time, TimerHandle & handle, TimeT & timeout, Ref<ITimerSource> & source);
+
+			/// Whether the timer has been taken by pop() and is still waiting to be requeued or removed.
+			bool running (const TimerHandle & handle) const;
+
+			/// Put a timer which was taken by pop() back into the queue with a new timeout.
+			void requeue (const TimerHandle & handle, TimeT timeout, TimeT current_time);
+
+		protected:
+			static const IndexT NONE = ~IndexT(0);
+
+			static const unsigned WHEEL_BITS = 6;
+			static const unsigned WHEEL_SLOTS = 1 << WHEEL_BITS;
+			static const TickT WHEEL_MASK = WHEEL_SLOTS - 1;
+			static const unsigned WHEELS = 6;
+
+			enum Location : std::uint8_t {
+				FREE,
+				HEAP,
+				WHEEL,
+				// Taken by pop() and being processed:
+				RUNNING,
+				// Reserved, and removed before it was inserted:
+				CANCELLED
+			};
+
+			struct Entry {
+				TimeT timeout;
+				Ref<ITimerSource> source;
+
+				Location location;
+
+				// Incremented each time the entry is released, so that stale handles can be detected:
+				std::uint32_t generation;
+
+				// The position in the heap:
+				IndexT heap_index;
+
+				// The tick at which the timer is due, and the list it is linked into:
+				TickT tick;
+				std::uint16_t list;
+				IndexT previous, next;
+			};
+
+			TimerQueueType _type;
+			std::size_t _size;
+
+			std::vector<Entry> _entries;
+
+			// Handles can be reserved on any thread, so the free handles and the number of entries which have been reserved are guarded by a lock. The entries themselves are only accessed by the loop thread, which grows them to include reserved entries as required.
+			std::mutex _reserve_lock;
+			std::vector<TimerHandle> _free_handles;
+			IndexT _reserved;
+
+			Entry & reserved_entry (IndexT index);
+			bool reserved (const TimerHandle & handle);
+
+			void release (IndexT index);
+			void recycle (IndexT index);
+
+			void place (IndexT index, TimeT current_time);
+			void detach (IndexT index);
+
+			// Binary heap of entry indices, ordered by timeout:
+			std::vector<IndexT> _heap;
+
+			bool before (IndexT a, IndexT b) const { return _entries[a].timeout < _entries[b].timeout; }
+			void heap_set (std::size_t position, IndexT index);
+			void heap_up (std::size_t position);
+			void heap_down (std::size_t position);
+			void heap_insert (IndexT index);
+			void heap_remove (IndexT index);
+
+			// Hierarchical timing wheel. Each wheel has 64 slots, and each slot has a doubly linked list of entries. A bitmap of non-empty slots is maintained for each wheel so that empty slots can be skipped.
+			TimeT _resolution;
+			TickT _current_tick;
+
+			std::uint64_t _pending[WHEELS];
+			IndexT _slots[WHEELS * WHEEL_SLOTS];
+
+			/// The first tick which is not before the given time.
+			TickT tick_for (TimeT time) const;
+
+			/// The last tick which is not after the given time.
+			TickT current_tick_for (TimeT time) const;
+
+			void link (IndexT index, IndexT & head, std::uint16_t list);
+			void unlink (IndexT index);
+
+			void wheel_insert (IndexT index);
+
+			/// The next tick at which a slot in the wheel needs to be processed.
+			bool next_tick (TickT & tick) const;
+
+			/// Advance the wheel to the given tick, cascading entries into lower wheels and moving due entries to the heap.
+			void advance (TickT tick);
+		};
+	}
+}
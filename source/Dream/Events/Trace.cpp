@@ -0,0 +1,271 @@
+//
+//  Trace.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cxxabi.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		Trace::Trace (std::size_t capacity) : _slots(new Slot[capacity]), _capacity(capacity), _head(0), _flows(0)
+		{
+			DREAM_ASSERT(capacity > 0);
+
+			for (std::size_t i = 0; i < capacity; i += 1)
+				_slots[i].sequence.store(0, std::memory_order_relaxed);
+		}
+
+		Trace::~Trace ()
+		{
+		}
+
+		std::uint64_t Trace::now ()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		std::uint32_t Trace::current_thread ()
+		{
+			static std::atomic<std::uint32_t> threads(0);
+			static thread_local std::uint32_t thread = ++threads;
+
+			return thread;
+		}
+
+		void Trace::append (const Record & record)
+		{
+			std::uint64_t head = _head.load(std::memory_order_relaxed);
+			Slot & slot = _slots[head % _capacity];
+
+			std::uint64_t words[Slot::WORDS] = {};
+			std::memcpy(words, &record, sizeof(Record));
+
+			// Readers which see any of the new words will also see that the slot is being written:
+			slot.sequence.store(0, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			for (std::size_t i = 0; i < Slot::WORDS; i += 1)
+				slot.words[i].store(words[i], std::memory_order_relaxed);
+
+			slot.sequence.store(head + 1, std::memory_order_release);
+			_head.store(head + 1, std::memory_order_release);
+		}
+
+		bool Trace::read (std::uint64_t index, Record & record) const
+		{
+			const Slot & slot = _slots[index % _capacity];
+
+			if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+				return false;
+
+			std::uint64_t words[Slot::WORDS];
+
+			for (std::size_t i = 0; i < Slot::WORDS; i += 1)
+				words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+			// If the slot was overwritten while it was being copied, the sequence will have changed:
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (slot.sequence.load(std::memory_order_relaxed) != index + 1)
+				return false;
+
+			std::memcpy(&record, words, sizeof(Record));
+
+			return true;
+		}
+
+		void Trace::record (char phase, const char * name, const std::type_info * type, FileDescriptor file_descriptor, std::uint64_t timestamp)
+		{
+			Record record;
+
+			record.timestamp = timestamp;
+			record.duration = 0;
+			record.name = name;
+			record.type = type;
+			record.flow = 0;
+			record.thread = current_thread();
+			record.file_descriptor = file_descriptor;
+			record.phase = phase;
+
+			append(record);
+		}
+
+		void Trace::begin (const char * name)
+		{
+			record('B', name, nullptr, -1, now());
+		}
+
+		void Trace::begin (const std::type_info & type, FileDescriptor file_descriptor)
+		{
+			record('B', nullptr, &type, file_descriptor, now());
+		}
+
+		void Trace::end ()
+		{
+			record('E', nullptr, nullptr, -1, now());
+		}
+
+		void Trace::complete (const char * name, std::uint64_t started, std::uint64_t duration)
+		{
+			Record record;
+
+			record.timestamp = started;
+			record.duration = duration;
+			record.name = name;
+			record.type = nullptr;
+			record.flow = 0;
+			record.thread = current_thread();
+			record.file_descriptor = -1;
+			record.phase = 'X';
+
+			append(record);
+		}
+
+		void Trace::flow (std::uint64_t posted, std::uint32_t producer)
+		{
+			_flows += 1;
+
+			// The start of the arrow is on the thread which posted the notification:
+			Record start;
+			start.timestamp = posted;
+			start.duration = 0;
+			start.name = "post";
+			start.type = nullptr;
+			start.flow = _flows;
+			start.thread = producer;
+			start.file_descriptor = -1;
+			start.phase = 's';
+			append(start);
+
+			// The end of the arrow binds to the enclosing span, which is processing the notification:
+			Record finish = start;
+			finish.timestamp = now();
+			finish.thread = current_thread();
+			finish.phase = 'f';
+			append(finish);
+		}
+
+		std::string type_name (const std::type_info & type)
+		{
+			int status = 0;
+			char * demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+			if (demangled) {
+				std::string name(demangled);
+				std::free(demangled);
+
+				return name;
+			}
+
+			return type.name();
+		}
+
+		/// Write a JSON string, escaping characters which may appear in demangled names, e.g. quotes in template arguments.
+		static void write_string (std::ostream & output, const std::string & string)
+		{
+			output << '"';
+
+			for (unsigned char character : string) {
+				if (character == '"' || character == '\\') {
+					output << '\\' << character;
+				} else if (character < 0x20) {
+					output << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (unsigned)character << std::dec << std::setfill(' ');
+				} else {
+					output << character;
+				}
+			}
+
+			output << '"';
+		}
+
+		void Trace::write (std::ostream & output) const
+		{
+			// The formatting of the caller's stream is restored once the events are written:
+			std::ios_base::fmtflags flags = output.flags();
+			std::streamsize precision = output.precision();
+
+			std::uint64_t head = _head.load(std::memory_order_acquire);
+			std::uint64_t first = head > _capacity ? head - _capacity : 0;
+
+			// Records which are overwritten while being copied are skipped:
+			std::vector<std::pair<std::uint64_t, Record>> records;
+			records.reserve(head - first);
+
+			for (std::uint64_t i = first; i < head; i += 1) {
+				Record record;
+
+				if (read(i, record))
+					records.push_back(std::make_pair(i, record));
+			}
+
+			// The slot of the oldest record is the next to be written, so it is discarded along with any records which were overwritten in the meantime:
+			std::uint64_t overwritten = _head.load(std::memory_order_acquire);
+
+			if (overwritten >= _capacity)
+				first = std::max(first, overwritten - _capacity + 1);
+
+			output << "{\"traceEvents\":[";
+
+			bool separator = false;
+
+			for (auto & item : records) {
+				if (item.first < first)
+					continue;
+
+				const Record & record = item.second;
+
+				if (separator)
+					output << ",";
+				separator = true;
+
+				output << "\n{\"ph\":\"" << record.phase << "\",\"pid\":1,\"tid\":" << record.thread;
+				output << ",\"ts\":" << std::fixed << std::setprecision(3) << (record.timestamp / 1000.0);
+
+				if (record.phase == 'X')
+					output << ",\"dur\":" << (record.duration / 1000.0);
+
+				if (record.name) {
+					output << ",\"name\":";
+					write_string(output, record.name);
+				} else if (record.type) {
+					output << ",\"name\":";
+					write_string(output, type_name(*record.type));
+				}
+
+				if (record.phase == 's' || record.phase == 'f') {
+					output << ",\"cat\":\"notification\",\"id\":" << record.flow;
+
+					if (record.phase == 'f')
+						output << ",\"bp\":\"e\"";
+				}
+
+				if (record.file_descriptor != -1)
+					output << ",\"args\":{\"fd\":" << record.file_descriptor << "}";
+
+				output << "}";
+			}
+
+			output << "\n]}" << std::endl;
+
+			output.flags(flags);
+			output.precision(precision);
+		}
+	}
+}
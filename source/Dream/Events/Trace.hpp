@@ -0,0 +1,122 @@
+//
+//  Trace.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Events.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// The readable (demangled) name of a type, e.g. of a source.
+		std::string type_name (const std::type_info & type);
+
+		/// Records what a loop is doing into a fixed size ring buffer, which can be written out in the Chrome trace event format (viewable with chrome://tracing or Perfetto). Events are recorded by the loop thread without locking or allocating, so tracing can be left enabled under load. When the buffer is full, the oldest events are overwritten.
+		class Trace : public Object {
+		public:
+			struct Record {
+				/// Nanoseconds since an arbitrary epoch which is shared by all threads.
+				std::uint64_t timestamp;
+				std::uint64_t duration;
+
+				/// The name is either a static string, or the name of the type of a source.
+				const char * name;
+				const std::type_info * type;
+
+				std::uint64_t flow;
+				std::uint32_t thread;
+				FileDescriptor file_descriptor;
+
+				/// The Chrome trace event phase, e.g. 'B' (begin) or 'E' (end).
+				char phase;
+			};
+
+		protected:
+			/// Records are copied in and out of slots a word at a time using relaxed atomic operations, so that other threads can read a slot while the loop thread overwrites it. The sequence is the index of the record in the slot plus one, or 0 while the slot is being written.
+			struct Slot {
+				static const std::size_t WORDS = (sizeof(Record) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+				std::atomic<std::uint64_t> sequence;
+				std::atomic<std::uint64_t> words[WORDS];
+			};
+
+			std::unique_ptr<Slot[]> _slots;
+			std::size_t _capacity;
+
+			// The number of records written, which is read by other threads to determine which records may be valid:
+			std::atomic<std::uint64_t> _head;
+			std::uint64_t _flows;
+
+			/// Add a record, overwriting the oldest record if the buffer is full.
+			void append (const Record & record);
+
+			/// Copy the record with the given index, unless it has been (or is being) overwritten. This function is thread-safe.
+			bool read (std::uint64_t index, Record & record) const;
+
+			void record (char phase, const char * name, const std::type_info * type, FileDescriptor file_descriptor, std::uint64_t timestamp);
+
+		public:
+			Trace (std::size_t capacity = 1 << 16);
+			virtual ~Trace ();
+
+			/// The current time in nanoseconds, as used for timestamps.
+			static std::uint64_t now ();
+
+			/// A small number which identifies the calling thread.
+			static std::uint32_t current_thread ();
+
+			/// Begin a named span, e.g. a phase of the loop.
+			void begin (const char * name);
+
+			/// Begin a span for processing a source, which is named after the type of the source.
+			void begin (const std::type_info & type, FileDescriptor file_descriptor = -1);
+
+			/// End the most recent span.
+			void end ();
+
+			/// A span which has already completed, e.g. the time spent blocked waiting for events.
+			void complete (const char * name, std::uint64_t started, std::uint64_t duration);
+
+			/// An arrow from the thread which posted a notification to the span which processes it.
+			void flow (std::uint64_t posted, std::uint32_t producer);
+
+			/// The number of records which have been written, including those which were overwritten.
+			std::uint64_t size () const { return _head.load(std::memory_order_acquire); }
+
+			/// Write the recorded events as Chrome trace JSON. Can be called from any thread. Events which are overwritten by the loop while they are being written out are discarded.
+			void write (std::ostream & output) const;
+		};
+
+		/// Records a span for the lifetime of the scope, if tracing is enabled.
+		class TraceScope {
+		protected:
+			Ref<Trace> _trace;
+
+		public:
+			TraceScope (Ptr<Trace> trace, const char * name) : _trace(trace)
+			{
+				if (_trace)
+					_trace->begin(name);
+			}
+
+			~TraceScope ()
+			{
+				if (_trace)
+					_trace->end();
+			}
+		};
+	}
+}
@@ -0,0 +1,263 @@
+//
+//  Watchdog.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include "Watchdog.hpp"
+
+#include <Dream/Core/Logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <errno.h>
+
+#if defined(TARGET_OS_LINUX) && defined(__GLIBC__)
+	#define DREAM_WATCHDOG_BACKTRACE
+
+	#include <execinfo.h>
+	#include <signal.h>
+#endif
+
+namespace Dream
+{
+	namespace Events
+	{
+		using namespace Logging;
+
+// MARK: -
+// MARK: Backtraces
+
+#if defined(DREAM_WATCHDOG_BACKTRACE)
+		static const int BACKTRACE_SIGNAL = SIGURG;
+		static const int MAXIMUM_FRAMES = 64;
+
+		// Written by the signal handler on the stalled thread:
+		static void * backtrace_frames[MAXIMUM_FRAMES];
+		static std::atomic<int> backtrace_frame_count(-1);
+
+		// Only one backtrace can be captured at a time:
+		static std::mutex backtrace_lock;
+
+		static void capture_frames (int)
+		{
+			int error = errno;
+			backtrace_frame_count.store(backtrace(backtrace_frames, MAXIMUM_FRAMES), std::memory_order_release);
+			errno = error;
+		}
+
+		/// Install the signal handler, unless the application handles the signal itself.
+		static bool install_backtrace_handler ()
+		{
+			static bool installed = [](){
+				// The first backtrace loads the unwinder, which may allocate, so it must not happen in the signal handler:
+				void * frame;
+				backtrace(&frame, 1);
+
+				struct sigaction existing;
+
+				if (sigaction(BACKTRACE_SIGNAL, nullptr, &existing) != 0)
+					return false;
+
+				if ((existing.sa_flags & SA_SIGINFO) || (existing.sa_handler != SIG_DFL && existing.sa_handler != SIG_IGN)) {
+					log_warning("Watchdog can't capture backtraces as the signal is already handled!");
+
+					return false;
+				}
+
+				struct sigaction action = {};
+				action.sa_handler = capture_frames;
+				action.sa_flags = SA_RESTART;
+				sigemptyset(&action.sa_mask);
+
+				return sigaction(BACKTRACE_SIGNAL, &action, nullptr) == 0;
+			}();
+
+			return installed;
+		}
+
+		static std::vector<std::string> capture_backtrace (const LoopActivity & activity, std::uint64_t heartbeat)
+		{
+			std::vector<std::string> lines;
+
+			if (!install_backtrace_handler())
+				return lines;
+
+			std::lock_guard<std::mutex> lock(backtrace_lock);
+
+			backtrace_frame_count.store(-1, std::memory_order_relaxed);
+
+			// The loop may have finished the stalled iteration, in which case its thread may have exited:
+			if (!activity.interrupt(heartbeat, BACKTRACE_SIGNAL))
+				return lines;
+
+			// The thread may be blocked with the signal masked, so don't wait for long:
+			for (std::size_t i = 0; i < 100 && backtrace_frame_count.load(std::memory_order_acquire) < 0; i += 1)
+				Core::sleep(0.001);
+
+			int count = backtrace_frame_count.load(std::memory_order_acquire);
+
+			if (count <= 0)
+				return lines;
+
+			if (char ** symbols = backtrace_symbols(backtrace_frames, count)) {
+				lines.assign(symbols, symbols + count);
+				std::free(symbols);
+			}
+
+			return lines;
+		}
+#else
+		static std::vector<std::string> capture_backtrace (const LoopActivity & activity, std::uint64_t heartbeat)
+		{
+			return std::vector<std::string>();
+		}
+#endif
+
+// MARK: -
+// MARK: class Watchdog
+
+		Watchdog::Watchdog (TimeT budget, CallbackT callback) : _budget(budget), _callback(callback), _backtrace(false), _stopping(false)
+		{
+			DREAM_ASSERT(budget > 0);
+		}
+
+		Watchdog::~Watchdog ()
+		{
+			stop();
+		}
+
+		void Watchdog::watch (Ref<Loop> loop)
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+
+			_loops.push_back(Watched{loop, 0, 0, false});
+		}
+
+		void Watchdog::ignore (Ref<Loop> loop)
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+
+			_loops.erase(std::remove_if(_loops.begin(), _loops.end(), [&](const Watched & watched) {
+				return watched.loop == loop;
+			}), _loops.end());
+		}
+
+		void Watchdog::start ()
+		{
+			if (!_thread) {
+				_stopping = false;
+				_thread = new std::thread(std::bind(&Watchdog::run, this));
+			}
+		}
+
+		void Watchdog::stop ()
+		{
+			if (_thread) {
+				{
+					std::lock_guard<std::mutex> lock(_lock);
+					_stopping = true;
+				}
+
+				_condition.notify_all();
+				_thread->join();
+
+				_thread = NULL;
+			}
+		}
+
+		bool Watchdog::check (Watched & watched, TimeT now, Stall & stall)
+		{
+			const LoopActivity & activity = watched.loop->activity();
+
+			std::uint64_t heartbeat = activity.heartbeat.load(std::memory_order_relaxed);
+
+			// A loop which is waiting for events or isn't running can't be stalled:
+			if (heartbeat != watched.heartbeat || activity.state.load(std::memory_order_relaxed) != LoopActivity::RUNNING) {
+				watched.heartbeat = heartbeat;
+				watched.since = now;
+				watched.reported = false;
+
+				return false;
+			}
+
+			if (watched.reported || (now - watched.since) < _budget)
+				return false;
+
+			watched.reported = true;
+
+			const std::type_info * source = activity.source.load(std::memory_order_relaxed);
+
+			stall.loop = watched.loop;
+			stall.source = source ? type_name(*source) : std::string();
+			stall.file_descriptor = activity.file_descriptor.load(std::memory_order_relaxed);
+			stall.duration = now - watched.since;
+
+			return true;
+		}
+
+		void Watchdog::run ()
+		{
+			Stopwatch stopwatch;
+			stopwatch.start();
+
+			// Check several times within the budget, so that stalls are reported promptly:
+			std::chrono::duration<TimeT> interval(_budget / 4);
+
+			std::unique_lock<std::mutex> lock(_lock);
+
+			while (!_stopping) {
+				_condition.wait_for(lock, interval);
+
+				if (_stopping)
+					break;
+
+				TimeT now = stopwatch.time();
+				std::vector<Stall> stalls;
+				std::vector<std::uint64_t> heartbeats;
+
+				for (auto & watched : _loops) {
+					Stall stall;
+
+					if (check(watched, now, stall)) {
+						stalls.push_back(stall);
+						heartbeats.push_back(watched.heartbeat);
+					}
+				}
+
+				if (stalls.empty())
+					continue;
+
+				// The callback may watch or ignore loops:
+				lock.unlock();
+
+				for (std::size_t i = 0; i < stalls.size(); i += 1) {
+					Stall & stall = stalls[i];
+
+					if (_backtrace)
+						stall.backtrace = capture_backtrace(stall.loop->activity(), heartbeats[i]);
+
+					_callback(stall);
+				}
+
+				lock.lock();
+			}
+		}
+
+		void Watchdog::log_stall (const Stall & stall)
+		{
+			if (stall.source.empty())
+				log_warning("Loop", stall.loop.get(), "has been stalled for", stall.duration, "seconds!");
+			else if (stall.file_descriptor == -1)
+				log_warning("Loop", stall.loop.get(), "has been stalled for", stall.duration, "seconds processing", stall.source);
+			else
+				log_warning("Loop", stall.loop.get(), "has been stalled for", stall.duration, "seconds processing", stall.source, "fd:", stall.file_descriptor);
+
+			for (auto & line : stall.backtrace)
+				log_warning("\t", line);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+//
+//  Watchdog.hpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#pragma once
+
+#include "Loop.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		/// A loop which hasn't made progress within the budget of a Watchdog.
+		struct Stall {
+			Ref<Loop> loop;
+
+			/// The name of the type of the source being processed, or empty if the loop was stalled between sources.
+			std::string source;
+			FileDescriptor file_descriptor;
+
+			/// How long the loop has been stalled, to within the interval at which the watchdog checks.
+			TimeT duration;
+
+			/// The stack of the loop thread, if it could be captured.
+			std::vector<std::string> backtrace;
+		};
+
+		/// Watches loops from a separate thread and reports any loop which is stuck processing the same source for longer than the budget, e.g. because a callback is blocking. The loops themselves only update a heartbeat (see LoopActivity), so watching a loop has very little overhead, and a stalled loop isn't interrupted. Each stall is reported once.
+		class Watchdog : public Object {
+		public:
+			typedef std::function<void (const Stall &)> CallbackT;
+
+		protected:
+			TimeT _budget;
+			CallbackT _callback;
+			bool _backtrace;
+
+			struct Watched {
+				Ref<Loop> loop;
+
+				std::uint64_t heartbeat;
+				TimeT since;
+				bool reported;
+			};
+
+			std::mutex _lock;
+			std::condition_variable _condition;
+			std::vector<Watched> _loops;
+			bool _stopping;
+
+			Shared<std::thread> _thread;
+
+			void run ();
+
+			/// Whether the loop has newly exceeded the budget, in which case the stall is filled in.
+			bool check (Watched & watched, TimeT now, Stall & stall);
+
+		public:
+			/// Loops are checked several times within the budget. By default, stalls are logged as warnings.
+			Watchdog (TimeT budget, CallbackT callback = log_stall);
+			virtual ~Watchdog ();
+
+			/// Whether to capture the stack of a stalled loop thread, which is only supported on Linux with glibc. Disabled by default. The stack is captured by interrupting the thread with SIGURG, for which a process-wide handler is installed unless the application has its own. This can conflict with other uses of SIGURG (e.g. out-of-band data or runtime preemption), and system calls in the stalled callback, e.g. poll or nanosleep, may fail with EINTR, which can change the behaviour being observed. This function is NOT thread-safe.
+			void set_backtrace (bool backtrace) { _backtrace = backtrace; }
+
+			/// Start watching a loop. This function is thread-safe.
+			void watch (Ref<Loop> loop);
+
+			/// Stop watching a loop. This function is thread-safe.
+			void ignore (Ref<Loop> loop);
+
+			/// Start checking loops on a new thread.
+			void start ();
+
+			/// Stop checking loops.
+			void stop ();
+
+			static void log_stall (const Stall & stall);
+		};
+	}
+}
@@ -31,6 +31,7 @@ define_target "dream-events-tests" do |target|
 	target.build do |environment|
 		test_root = target.package.path + 'test'
 		
+		# Test.Coroutine.cpp is guarded by DREAM_EVENTS_COROUTINES, so it is empty when built as C++11:
 		run tests: "DreamEvents", source_files: test_root.glob('Dream/**/*.cpp')
 	end
 	
@@ -42,6 +43,37 @@ define_target "dream-events-tests" do |target|
 	target.provides "Test/DreamEvents"
 end
 
+# The coroutine support requires C++20, so the coroutine tests are built separately as C++20:
+define_target "dream-events-coroutine-tests" do |target|
+	target.build do |environment|
+		test_root = target.package.path + 'test'
+		
+		run tests: "DreamEventsCoroutines", source_files: test_root.glob('Dream/Events/Test.Coroutine.cpp')
+	end
+	
+	target.depends "Language/C++20", private: true
+	
+	target.depends "Library/UnitTest"
+	target.depends "Library/DreamEvents"
+	
+	target.provides "Test/DreamEvents/Coroutines"
+end
+
+define_target "dream-events-benchmarks" do |target|
+	target.build do |environment|
+		benchmark_root = target.package.path + 'benchmark'
+		
+		run tests: "DreamEventsBenchmarks", source_files: benchmark_root.glob('Dream/**/*.cpp')
+	end
+	
+	target.depends "Language/C++11", private: true
+	
+	target.depends "Library/UnitTest"
+	target.depends "Library/DreamEvents"
+	
+	target.provides "Benchmark/DreamEvents"
+end
+
 define_configuration "test" do |configuration|
 	configuration[:source] = "https://github.com/kurocha"
 	
@@ -0,0 +1,146 @@
+//
+//  Test.Acceptor.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Acceptor.hpp>
+#include <Dream/Events/Group.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite AcceptorTestSuite {
+			"Dream::Events::ShardedAcceptor",
+
+			{"it should accept connections on every loop",
+				[](UnitTest::Examiner & examiner) {
+					const int COUNT = 64;
+
+					Ref<LoopGroup> group = new LoopGroup(2);
+					group->start();
+
+					std::atomic<int> accepted(0);
+					std::mutex lock;
+					std::set<Loop *> loops;
+
+					sockaddr_in address = {};
+					address.sin_family = AF_INET;
+					address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+					address.sin_port = 0;
+
+					Ref<ShardedAcceptor> acceptor = new ShardedAcceptor(group->loops(), (const sockaddr *)&address, sizeof(address), [&](Loop * loop, AcceptorSource *, FileDescriptor connection) {
+						{
+							std::lock_guard<std::mutex> guard(lock);
+							loops.insert(loop);
+						}
+
+						::close(connection);
+						accepted += 1;
+					});
+
+					examiner << "One socket was opened for each loop";
+					examiner.expect(acceptor->size()) == 2;
+
+					// Connections are distributed by the kernel based on the address of the client:
+					int failed = 0;
+
+					for (int i = 0; i < COUNT; i += 1) {
+						FileDescriptor client = socket(AF_INET, SOCK_STREAM, 0);
+
+						if (connect(client, acceptor->address(), acceptor->address_length()) != 0)
+							failed += 1;
+
+						::close(client);
+					}
+
+					examiner << "All clients connected";
+					examiner.expect(failed) == 0;
+
+					for (int i = 0; i < 200 && accepted < COUNT; i += 1)
+						Core::sleep(0.01);
+
+					acceptor->close();
+					group->stop();
+
+					examiner << "All connections were accepted";
+					examiner.expect(accepted.load()) == COUNT;
+
+					examiner << "Connections were accepted by both loops";
+					examiner.expect(loops.size()) == 2;
+				}
+			},
+
+			{"it should pause accepting when the process runs out of file descriptors",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					int accepted = 0;
+
+					sockaddr_in address = {};
+					address.sin_family = AF_INET;
+					address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+					address.sin_port = 0;
+
+					Ref<ShardedAcceptor> acceptor = new ShardedAcceptor({loop}, (const sockaddr *)&address, sizeof(address), [&](Loop *, AcceptorSource *, FileDescriptor connection) {
+						::close(connection);
+						accepted += 1;
+					});
+
+					// Process the notification which monitors the socket:
+					loop->run_until_timeout(0.01);
+
+					FileDescriptor client = socket(AF_INET, SOCK_STREAM, 0);
+					connect(client, acceptor->address(), acceptor->address_length());
+
+					// Lower the limit to the next file descriptor, so that accepting the connection fails with EMFILE:
+					rlimit limit, lowered;
+					getrlimit(RLIMIT_NOFILE, &limit);
+
+					FileDescriptor next = open("/dev/null", O_RDONLY);
+					::close(next);
+
+					lowered = limit;
+					lowered.rlim_cur = next;
+					setrlimit(RLIMIT_NOFILE, &lowered);
+
+					std::size_t iterations = loop->metrics().iterations.value();
+					loop->run_until_timeout(0.3);
+					iterations = loop->metrics().iterations.value() - iterations;
+
+					setrlimit(RLIMIT_NOFILE, &limit);
+
+					examiner << "Connection couldn't be accepted";
+					examiner.expect(accepted) == 0;
+
+					examiner << "Loop didn't spin while the socket was readable";
+					examiner.expect(iterations) < 50;
+
+					loop->run_until_timeout(0.3);
+
+					examiner << "Connection was accepted once file descriptors were available";
+					examiner.expect(accepted) == 1;
+
+					::close(client);
+					acceptor->close();
+				}
+			},
+		};
+	}
+}
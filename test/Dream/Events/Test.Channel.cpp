@@ -0,0 +1,170 @@
+//
+//  Test.Channel.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Channel.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite ChannelTestSuite {
+			"Dream::Events::Channel",
+
+			{"it should deliver items sent from another thread in batches",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 10000;
+
+					Ref<Loop> event_loop = new Loop;
+					event_loop->set_stop_when_idle(false);
+
+					std::size_t received = 0, batches = 0;
+					bool ordered = true;
+
+					Ref<Channel<std::unique_ptr<std::size_t>>> channel = new Channel<std::unique_ptr<std::size_t>>(event_loop, [&](Loop * loop, std::vector<std::unique_ptr<std::size_t>> & items){
+						batches += 1;
+
+						for (auto & item : items) {
+							ordered = ordered && *item == received;
+							received += 1;
+						}
+
+						if (received == COUNT)
+							loop->stop();
+					});
+
+					std::thread producer([&](){
+						for (std::size_t i = 0; i < COUNT; i += 1)
+							channel->send(std::unique_ptr<std::size_t>(new std::size_t(i)));
+					});
+
+					event_loop->run_until_timeout(2.0);
+
+					producer.join();
+
+					examiner << "All items were delivered in order";
+					examiner.expect(received) == COUNT;
+					examiner.expect(ordered) == true;
+
+					examiner << "Items were delivered in batches";
+					examiner.expect(batches) < COUNT;
+
+					examiner << "The loop was notified once for each batch";
+					examiner.expect(event_loop->metrics().notification_depth.total()) == batches;
+				}
+			},
+
+			{"it should deliver items sent from the loop thread after the callback returns",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> event_loop = new Loop;
+
+					std::vector<int> received;
+					std::size_t depth = 0, maximum_depth = 0;
+
+					Ref<Channel<int>> channel;
+
+					channel = new Channel<int>(event_loop, [&](Loop * loop, std::vector<int> & items){
+						depth += 1;
+						maximum_depth = std::max(maximum_depth, depth);
+
+						for (auto item : items) {
+							received.push_back(item);
+
+							// Items sent by the callback are delivered in the next batch:
+							if (item < 3)
+								channel->send(item + 1);
+						}
+
+						depth -= 1;
+					});
+
+					// Run the loop once, so that the items are sent from the loop thread:
+					event_loop->run_once(false);
+
+					std::vector<int> items = {0};
+					channel->send(items.begin(), items.end());
+
+					for (std::size_t i = 0; i < 10 && received.size() < 4; i += 1)
+						event_loop->run_once(false);
+
+					examiner << "All items were delivered";
+					examiner.expect(received.size()) == 4;
+
+					examiner << "The callback was never re-entered";
+					examiner.expect(maximum_depth) == 1;
+				}
+			},
+
+			{"it should not deliver items again if the callback throws",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> event_loop = new Loop;
+
+					std::vector<int> received;
+
+					Ref<Channel<int>> channel = new Channel<int>(event_loop, [&](Loop * loop, std::vector<int> & items){
+						for (auto item : items)
+							received.push_back(item);
+
+						if (items.front() == 0)
+							throw std::runtime_error("Could not process items!");
+					});
+
+					event_loop->run_once(false);
+
+					channel->send(0);
+
+					bool thrown = false;
+
+					try {
+						event_loop->run_once(false);
+					} catch (std::runtime_error & error) {
+						thrown = true;
+					}
+
+					channel->send(1);
+					event_loop->run_once(false);
+
+					examiner << "The exception was thrown by the loop";
+					examiner.expect(thrown) == true;
+
+					examiner << "Each item was delivered once";
+					examiner.expect(received.size()) == 2;
+					examiner.expect(received.back()) == 1;
+				}
+			},
+
+			{"it should release items which are waiting when the loop is destroyed",
+				[](UnitTest::Examiner & examiner) {
+					std::weak_ptr<int> item;
+
+					{
+						Ref<Loop> event_loop = new Loop;
+
+						Ref<Channel<std::shared_ptr<int>>> channel = new Channel<std::shared_ptr<int>>(event_loop, [&](Loop * loop, std::vector<std::shared_ptr<int>> & items){
+						});
+
+						std::shared_ptr<int> value(new int(10));
+						item = value;
+
+						channel->send(std::move(value));
+					}
+
+					examiner << "The channel and its items were released with the loop";
+					examiner.expect(item.expired()) == true;
+				}
+			},
+		};
+	}
+}
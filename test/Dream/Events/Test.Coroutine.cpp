@@ -0,0 +1,197 @@
+//
+//  Test.Coroutine.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Coroutine.hpp>
+
+#if defined(DREAM_EVENTS_COROUTINES)
+
+#include <Dream/Events/Thread.hpp>
+
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		static Task read_messages (Ref<AsyncFileDescriptor> file, int & count)
+		{
+			char buffer[16];
+
+			while (count < 10) {
+				co_await file->readable();
+
+				if (read(file->file_descriptor(), buffer, sizeof(buffer)) > 0)
+					count += 1;
+			}
+
+			file->stop();
+		}
+
+		static Task read_messages (Ref<Loop> loop, FileDescriptor file_descriptor, int & count)
+		{
+			char buffer[16];
+
+			while (count < 10) {
+				co_await readable(loop, file_descriptor);
+
+				if (read(file_descriptor, buffer, sizeof(buffer)) > 0)
+					count += 1;
+			}
+		}
+
+		static Task write_messages (Ref<Loop> loop, FileDescriptor file_descriptor)
+		{
+			for (int i = 0; i < 10; i += 1) {
+				co_await sleep_for(loop, 0.001);
+				co_await writable(loop, file_descriptor);
+
+				write(file_descriptor, "x", 1);
+			}
+		}
+
+		static Task bounce (Ref<Loop> loop, Ref<Loop> remote, bool & resumed_remotely, bool & resumed_locally)
+		{
+			co_await resume_on(remote);
+			resumed_remotely = remote->on_loop_thread();
+
+			co_await resume_on(loop);
+			resumed_locally = loop->on_loop_thread();
+
+			loop->stop();
+		}
+
+		static Task compute (Ref<Loop> loop, Ref<Loop> remote, int & result, bool & failed)
+		{
+			result = co_await remote->invoke([](Loop *){
+				return 6 * 7;
+			});
+
+			co_await remote->invoke([](Loop *){});
+
+			try {
+				co_await remote->invoke([](Loop *) -> int {
+					throw std::runtime_error("failed");
+				});
+			} catch (std::runtime_error & exception) {
+				failed = true;
+			}
+
+			loop->stop();
+		}
+
+		UnitTest::Suite CoroutineTestSuite {
+			"Dream::Events::Coroutine",
+
+			{"it should await file descriptors and timers",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+
+					int sockets[2];
+					socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+					int count = 0;
+
+					loop->post_notification(new NotificationSource([&](Loop *, NotificationSource *, Event) {
+						read_messages(new AsyncFileDescriptor(loop, sockets[0]), count);
+						write_messages(loop, sockets[1]);
+					}));
+
+					loop->run_until_timeout(1.0);
+
+					close(sockets[0]);
+					close(sockets[1]);
+
+					examiner << "All messages were read";
+					examiner.expect(count) == 10;
+				}
+			},
+
+			{"it should await file descriptors without monitoring them persistently",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+
+					int sockets[2];
+					socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+					int count = 0;
+
+					loop->post_notification(new NotificationSource([&](Loop *, NotificationSource *, Event) {
+						read_messages(loop, sockets[0], count);
+						write_messages(loop, sockets[1]);
+					}));
+
+					loop->run_until_timeout(1.0);
+
+					close(sockets[0]);
+					close(sockets[1]);
+
+					examiner << "All messages were read";
+					examiner.expect(count) == 10;
+				}
+			},
+
+			{"it should resume on a different loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					bool resumed_remotely = false, resumed_locally = false;
+
+					loop->post_notification(new NotificationSource([&](Loop *, NotificationSource *, Event) {
+						bounce(loop, thread->loop(), resumed_remotely, resumed_locally);
+					}));
+
+					loop->run_until_timeout(1.0);
+					thread->stop();
+
+					examiner << "Coroutine was resumed on the remote loop";
+					examiner.expect(resumed_remotely) == true;
+
+					examiner << "Coroutine was resumed on the original loop";
+					examiner.expect(resumed_locally) == true;
+				}
+			},
+
+			{"it should await the result of a function invoked on a different loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					int result = 0;
+					bool failed = false;
+
+					loop->post_urgent([&](Loop *) {
+						compute(loop, thread->loop(), result, failed);
+					});
+
+					loop->run_until_timeout(1.0);
+					thread->stop();
+
+					examiner << "Result was returned";
+					examiner.expect(result) == 42;
+
+					examiner << "Exception was rethrown in the coroutine";
+					examiner.expect(failed) == true;
+				}
+			},
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,166 @@
+//
+//  Test.Executor.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Executor.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite ExecutorTestSuite {
+			"Dream::Events::Executor",
+
+			{"it should complete tasks on the originating loop",
+				[](UnitTest::Examiner & examiner) {
+					const int COUNT = 1000;
+
+					Ref<Executor> executor = new Executor(4);
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					int completed = 0, total = 0;
+					bool same_thread = true;
+					std::thread::id loop_thread = std::this_thread::get_id();
+
+					// Submit from within the loop, so that completions are delivered to a running loop:
+					loop->post_notification(new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+						for (int i = 0; i < COUNT; i += 1) {
+							executor->submit([i]() {
+								return i;
+							}, loop, [&](Loop * loop, int result) {
+								if (std::this_thread::get_id() != loop_thread)
+									same_thread = false;
+
+								completed += 1;
+								total += result;
+
+								if (completed == COUNT)
+									loop->stop();
+							});
+						}
+					}));
+
+					loop->run_until_timeout(5.0);
+
+					examiner << "All completions were invoked";
+					examiner.expect(completed) == COUNT;
+					examiner.expect(total) == COUNT * (COUNT - 1) / 2;
+
+					examiner << "Completions were invoked on the loop thread";
+					examiner.expect(same_thread) == true;
+
+					executor->stop();
+
+					examiner << "All tasks were executed";
+					examiner.expect(executor->statistics().executed) == COUNT;
+					examiner.expect(executor->statistics().queued) == 0;
+				}
+			},
+
+			{"it should deliver exceptions thrown by tasks to the originating loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Executor> executor = new Executor(2);
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					int completed = 0, failed = 0, unknown = 0;
+
+					loop->post_notification(new NotificationSource([&](Loop * loop, NotificationSource *, Event){
+						auto completion = [&](Loop * loop, int) {
+							completed += 1;
+						};
+
+						auto failure = [&](Loop * loop, std::exception_ptr error) {
+							try {
+								std::rethrow_exception(error);
+							} catch (std::runtime_error &) {
+								failed += 1;
+							} catch (...) {
+								unknown += 1;
+							}
+
+							if (failed + unknown == 2)
+								loop->stop();
+						};
+
+						executor->submit([]() -> int {
+							throw std::runtime_error("failed");
+						}, loop, completion, failure);
+
+						// Exceptions which aren't derived from std::exception are delivered too:
+						executor->submit([]() -> int {
+							throw 42;
+						}, loop, completion, failure);
+					}));
+
+					loop->run_until_timeout(5.0);
+
+					examiner << "Failures were delivered instead of completions";
+					examiner.expect(failed) == 1;
+					examiner.expect(unknown) == 1;
+					examiner.expect(completed) == 0;
+
+					executor->stop();
+
+					examiner << "Workers survived the exceptions";
+					examiner.expect(executor->statistics().executed) == 2;
+				}
+			},
+
+			{"it should run tasks submitted after stopping on the calling thread",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Executor> executor = new Executor(2);
+					executor->stop();
+
+					std::thread::id thread;
+
+					executor->submit([&]() {
+						thread = std::this_thread::get_id();
+					});
+
+					examiner << "Task was run on the calling thread";
+					examiner.expect(thread == std::this_thread::get_id()) == true;
+				}
+			},
+
+			{"it should steal tasks submitted by a busy worker",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Executor> executor = new Executor(4);
+
+					std::atomic<int> count(0);
+
+					// All tasks are submitted to the deque of a single worker:
+					executor->submit([&]() {
+						for (int i = 0; i < 100; i += 1) {
+							executor->submit([&]() {
+								Core::sleep(0.001);
+								count += 1;
+							});
+						}
+					});
+
+					for (int i = 0; i < 500 && count < 100; i += 1)
+						Core::sleep(0.01);
+
+					executor->stop();
+
+					examiner << "All tasks were executed";
+					examiner.expect(count.load()) == 100;
+
+					examiner << "Idle workers stole tasks";
+					examiner.expect(executor->statistics().stolen) > 0;
+				}
+			},
+		};
+	}
+}
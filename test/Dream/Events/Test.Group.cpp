@@ -0,0 +1,78 @@
+//
+//  Test.Group.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Group.hpp>
+#include <Dream/Events/Source.hpp>
+
+#include <atomic>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite GroupTestSuite {
+			"Dream::Events::LoopGroup",
+
+			{"it should run functions on every loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<LoopGroup> group = new LoopGroup(4);
+					group->start();
+
+					std::atomic<int> count(0);
+
+					group->for_each_loop([&](Loop *){
+						count += 1;
+					});
+
+					for (int i = 0; i < 100 && count < 4; i += 1)
+						Core::sleep(0.01);
+
+					group->stop();
+
+					examiner << "Function was invoked on every loop";
+					examiner.expect(count.load()) == 4;
+				}
+			},
+
+			{"it should assign timers round-robin",
+				[](UnitTest::Examiner & examiner) {
+					Ref<LoopGroup> group = new LoopGroup(4, ROUND_ROBIN);
+
+					for (std::size_t i = 0; i < 8; i += 1) {
+						examiner << "Timer was assigned to the next loop";
+						examiner.expect(group->schedule_timer(new TimerSource([](Loop *, TimerSource *, Event){}, 10)) == group->loop(i % 4)) == true;
+					}
+				}
+			},
+
+			{"it should assign timers to the least loaded loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<LoopGroup> group = new LoopGroup(2, LEAST_LOADED);
+					group->start();
+
+					// Give the first loop some work:
+					for (std::size_t i = 0; i < 3; i += 1)
+						group->loop(0)->schedule_timer(new TimerSource([](Loop *, TimerSource *, Event){}, 10));
+
+					for (int i = 0; i < 100 && group->loop(0)->load() < 3; i += 1)
+						Core::sleep(0.01);
+
+					// Assigned timers are accounted for before they are added by the loop:
+					for (std::size_t i = 0; i < 3; i += 1) {
+						examiner << "Timer was assigned to the second loop";
+						examiner.expect(group->schedule_timer(new TimerSource([](Loop *, TimerSource *, Event){}, 10)) == group->loop(1)) == true;
+					}
+
+					group->stop();
+				}
+			},
+		};
+	}
+}
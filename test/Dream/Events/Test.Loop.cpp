@@ -9,6 +9,8 @@
 #include <UnitTest/UnitTest.hpp>
 #include <Dream/Events/Loop.hpp>
 
+#include <unistd.h>
+
 namespace Dream
 {
 	namespace Events
@@ -43,6 +45,136 @@ namespace Dream
 					examiner.expect(timer_stopped) == false;
 				}
 			},
+
+			{"the time budget should stop notifications from starving timers",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 500;
+
+					Ref<Loop> event_loop = new Loop;
+					event_loop->set_time_budget(0.002);
+
+					std::size_t processed = 0, processed_before_timer = 0;
+
+					// The loop hasn't run yet, so the timer and functions are queued as notifications, rather than being handled directly:
+					event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+						processed_before_timer = processed;
+					}, 0.01));
+
+					for (std::size_t i = 0; i < COUNT; i += 1) {
+						event_loop->post([&](Loop *){
+							Core::sleep(0.0001);
+							processed += 1;
+						});
+					}
+
+					while (processed < COUNT)
+						event_loop->run_once(false);
+
+					examiner << "Timer fired before all the notifications were processed";
+					examiner.expect(processed_before_timer) < COUNT;
+
+					examiner << "Notifications were deferred to later iterations";
+					examiner.expect(event_loop->metrics().notifications_deferred.value()) > 0;
+				}
+			},
+
+			{"the time budget should leave time for timers and notifications while file descriptors are busy",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 50;
+
+					Ref<Loop> event_loop = new Loop;
+					event_loop->set_stop_when_idle(false);
+
+					int pipe_file_descriptors[2];
+					pipe(pipe_file_descriptors);
+
+					// The pipe is never read, so it is always ready, and dispatching it takes longer than the whole budget:
+					write(pipe_file_descriptors[1], "!", 1);
+
+					Ref<FileDescriptorSource> source = new FileDescriptorSource([&](Loop *, FileDescriptorSource *, Event){
+						Core::sleep(0.006);
+					}, pipe_file_descriptors[0]);
+
+					event_loop->monitor(source, READ_READY);
+
+					std::size_t fired = 0, processed = 0;
+
+					auto schedule = [&](std::size_t count) {
+						for (std::size_t i = 0; i < count; i += 1) {
+							event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+								Core::sleep(0.0001);
+								fired += 1;
+							}, 0));
+						}
+
+						// Posted from a separate thread, so that they are queued rather than invoked immediately:
+						std::thread producer([&](){
+							for (std::size_t i = 0; i < count; i += 1) {
+								event_loop->post([&](Loop *){
+									Core::sleep(0.0001);
+									processed += 1;
+								});
+							}
+						});
+
+						producer.join();
+					};
+
+					// Let the measured cost of file descriptors exceed the budget, while measuring the cost of timers and notifications:
+					schedule(5);
+
+					for (std::size_t i = 0; i < 20; i += 1)
+						event_loop->run_once(false);
+
+					fired = processed = 0;
+					schedule(COUNT);
+
+					for (std::size_t i = 0; i < 10; i += 1)
+						event_loop->run_once(false);
+
+					event_loop->stop_monitoring_file_descriptor(source);
+
+					close(pipe_file_descriptors[0]);
+					close(pipe_file_descriptors[1]);
+
+					examiner << "Timers made progress while file descriptors were busy";
+					examiner.expect(fired) == COUNT;
+
+					examiner << "Notifications made progress while file descriptors were busy";
+					examiner.expect(processed) == COUNT;
+				}
+			},
+
+			{"timers scheduled by notifications are not slept past",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> event_loop = new Loop;
+					event_loop->set_stop_when_idle(false);
+
+					TimeT fired_at = -1;
+
+					// The loop hasn't run yet, so the function is queued and processed just before the loop waits:
+					event_loop->post([&](Loop * loop){
+						loop->schedule_timer(new TimerSource([&](Loop * loop, TimerSource *, Event){
+							fired_at = loop->stopwatch().time();
+							loop->stop();
+						}, 0.01));
+					});
+
+					std::thread stop_thread([&](){
+						// If the loop waits without a timeout, it is stopped from a "remote" thread:
+						Core::sleep(1.0);
+						event_loop->stop();
+					});
+
+					event_loop->run_forever();
+
+					stop_thread.join();
+
+					examiner << "Timer fired without waiting for another event";
+					examiner.expect(fired_at) >= 0.0;
+					examiner.expect(fired_at) < 0.5;
+				}
+			},
 		};
 	}
 }
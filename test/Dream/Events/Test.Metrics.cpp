@@ -0,0 +1,131 @@
+//
+//  Test.Metrics.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Loop.hpp>
+#include <Dream/Events/Metrics.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite MetricsTestSuite {
+			"Dream::Events::Metrics",
+
+			{"histograms should report percentiles within their precision",
+				[](UnitTest::Examiner & examiner) {
+					Histogram histogram;
+
+					examiner << "Empty histogram has no percentiles";
+					examiner.expect(histogram.percentile(50)) == 0;
+
+					for (std::uint64_t i = 1; i <= 1000; i += 1)
+						histogram.record(i * 1000);
+
+					examiner << "All values were counted";
+					examiner.expect(histogram.count()) == 1000;
+					examiner.expect(histogram.maximum()) == 1000000;
+
+					std::uint64_t median = histogram.percentile(50);
+
+					examiner << "Median is within the precision of the histogram";
+					examiner.expect(median) >= 500000;
+					examiner.expect(median) <= 500000 + 500000 / Histogram::SUB_BUCKETS;
+
+					examiner << "Percentiles never exceed the maximum";
+					examiner.expect(histogram.percentile(100)) == 1000000;
+				}
+			},
+
+			{"loops should record timers and notifications",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->run_once(false);
+
+					std::size_t fired = 0;
+
+					loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event) {
+						fired += 1;
+					}, 0.01));
+
+					std::thread producer([&](){
+						for (std::size_t i = 0; i < 10; i += 1)
+							loop->post([](Loop *){});
+					});
+
+					producer.join();
+
+					loop->run_until_timeout(0.1);
+
+					const LoopMetrics & metrics = loop->metrics();
+
+					examiner << "Loop ran through iterations";
+					examiner.expect(metrics.iterations.value()) > 0;
+
+					examiner << "Timer lateness was recorded";
+					examiner.expect(metrics.timer_lateness.count()) == fired;
+
+					examiner << "Notifications were fetched from the queue";
+					examiner.expect(metrics.notification_depth.total()) == 10;
+
+					examiner << "Loop was blocked waiting for the timer";
+					examiner.expect(metrics.blocked_time.value()) > 0;
+				}
+			},
+
+			{"CPU sets should hold CPUs beyond the first 64",
+				[](UnitTest::Examiner & examiner) {
+					CPUSet set;
+
+					examiner << "The set is initially empty";
+					examiner.expect(set.cpus().empty()) == true;
+
+					set.assign({200, 3, 64, CPUSet::MAXIMUM});
+
+					std::vector<unsigned> cpus = set.cpus();
+
+					examiner << "CPUs within the range are held in ascending order";
+					examiner.expect(cpus.size()) == 3;
+					examiner.expect(cpus == std::vector<unsigned>({3, 64, 200})) == true;
+					examiner.expect(set.contains(200)) == true;
+
+					examiner << "CPUs beyond the range are ignored";
+					examiner.expect(set.contains(CPUSet::MAXIMUM)) == false;
+				}
+			},
+
+			{"loops should only be interrupted while running the given iteration",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+
+					bool interrupted = false;
+					std::uint64_t heartbeat = 0;
+
+					loop->post([&](Loop * loop){
+						heartbeat = loop->activity().heartbeat.load();
+
+						// A null signal only checks whether the thread can be signalled:
+						interrupted = loop->activity().interrupt(heartbeat, 0);
+					});
+
+					loop->run_once(false);
+
+					examiner << "The running loop could be interrupted";
+					examiner.expect(interrupted) == true;
+
+					examiner << "The loop can't be interrupted once it has finished the iteration";
+					examiner.expect(loop->activity().interrupt(heartbeat, 0)) == false;
+				}
+			},
+		};
+	}
+}
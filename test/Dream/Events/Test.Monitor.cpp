@@ -0,0 +1,148 @@
+//
+//  Test.Monitor.cpp
+//  File file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Loop.hpp>
+#include <Dream/Events/Source.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Dream
+{
+	namespace Events
+	{
+		static std::size_t count_reads (MonitorType monitor_type)
+		{
+			Ref<Loop> event_loop = new Loop(monitor_type);
+
+			int sockets[2];
+			socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+			std::size_t reads = 0;
+
+			Ref<FileDescriptorSource> reader = new FileDescriptorSource([&](Loop * loop, FileDescriptorSource * source, Event event){
+				if (event & READ_READY) {
+					char buffer[32];
+					read(source->file_descriptor(), buffer, sizeof(buffer));
+
+					reads += 1;
+
+					if (reads == 3)
+						loop->stop_monitoring_file_descriptor(source);
+				}
+			}, sockets[0]);
+
+			Ref<TimerSource> writer = new TimerSource([&](Loop *, TimerSource *, Event){
+				write(sockets[1], "!", 1);
+			}, 0.01, true);
+
+			event_loop->set_stop_when_idle(false);
+			event_loop->monitor(reader);
+			event_loop->schedule_timer(writer);
+
+			event_loop->run_until_timeout(0.1);
+
+			writer->cancel();
+
+			close(sockets[0]);
+			close(sockets[1]);
+
+			return reads;
+		}
+
+		static std::size_t count_writes (MonitorType monitor_type)
+		{
+			Ref<Loop> event_loop = new Loop(monitor_type);
+
+			int sockets[2];
+			socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+			std::size_t writes = 0;
+
+			// The socket is always writable, so it would wake up the loop continuously if the interest wasn't updated:
+			Ref<FileDescriptorSource> writer = new FileDescriptorSource([&](Loop * loop, FileDescriptorSource * source, Event event){
+				if (event & WRITE_READY) {
+					write(source->file_descriptor(), "!", 1);
+					writes += 1;
+
+					loop->set_interest(source, READ_READY);
+				}
+			}, sockets[0]);
+
+			event_loop->set_stop_when_idle(false);
+			event_loop->monitor(writer, WRITE_READY);
+
+			event_loop->run_until_timeout(0.05);
+
+			event_loop->stop_monitoring_file_descriptor(writer);
+
+			close(sockets[0]);
+			close(sockets[1]);
+
+			return writes;
+		}
+
+		UnitTest::Suite MonitorTestSuite {
+			"Dream::Events::Monitor",
+
+			{"the poll monitor dispatches read events",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Reader stopped after three reads";
+					examiner.expect(count_reads(POLL_MONITOR)) == 3;
+				}
+			},
+
+			{"the poll monitor respects the interest of a source",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Writer was only notified until it lost interest";
+					examiner.expect(count_writes(POLL_MONITOR)) == 1;
+				}
+			},
+
+			{"the system monitor respects the interest of a source",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Writer was only notified until it lost interest";
+					examiner.expect(count_writes(SYSTEM_MONITOR)) == 1;
+				}
+			},
+
+			{"the io_uring monitor respects the interest of a source",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Writer was only notified until it lost interest";
+					examiner.expect(count_writes(IO_URING_MONITOR)) == 1;
+				}
+			},
+
+			{"the system monitor dispatches read events",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Reader stopped after three reads";
+					examiner.expect(count_reads(SYSTEM_MONITOR)) == 3;
+				}
+			},
+
+#if defined(TARGET_OS_LINUX)
+			{"the epoll monitor dispatches read events",
+				[](UnitTest::Examiner & examiner) {
+					examiner << "Reader stopped after three reads";
+					examiner.expect(count_reads(EPOLL_MONITOR)) == 3;
+				}
+			},
+
+			{"the io_uring monitor dispatches read events",
+				[](UnitTest::Examiner & examiner) {
+					// Falls back to the system monitor if io_uring isn't supported by the kernel:
+					examiner << "Reader stopped after three reads";
+					examiner.expect(count_reads(IO_URING_MONITOR)) == 3;
+				}
+			},
+#endif
+		};
+	}
+}
@@ -11,6 +11,10 @@
 #include <Dream/Events/Loop.hpp>
 #include <Dream/Events/Source.hpp>
 
+#include <vector>
+#include <array>
+#include <memory>
+
 namespace Dream
 {
 	namespace Events
@@ -51,6 +55,235 @@ namespace Dream
 					examiner.expect(notification_count) == 10;
 				}
 			},
+
+			{"it should process a burst of urgent notifications",
+				[](UnitTest::Examiner & examiner) {
+					auto event_loop = ref(new Loop);
+
+					int notification_count = 0;
+
+					auto notification = ref(new NotificationSource([&](Loop *, NotificationSource *, Event){
+						notification_count += 1;
+
+						if (notification_count >= 1000)
+							event_loop->stop();
+					}));
+
+					// Urgent notifications posted before the loop has woken up are coalesced into a single wake up:
+					std::thread notification_thread([&](){
+						for (int i = 0; i < 1000; i += 1) {
+							event_loop->post_notification(notification, true);
+						}
+					});
+
+					event_loop->set_stop_when_idle(false);
+					event_loop->run_until_timeout(1.0);
+
+					notification_thread.join();
+
+					examiner << "All notifications occurred";
+					examiner.expect(notification_count) == 1000;
+				}
+			},
+
+			{"it should process notifications from multiple threads in order",
+				[](UnitTest::Examiner & examiner) {
+					const int PRODUCERS = 4, COUNT = 1000;
+
+					auto event_loop = ref(new Loop);
+
+					int notification_count = 0;
+					std::vector<int> last(PRODUCERS, -1);
+					bool ordered = true;
+
+					std::vector<std::thread> producers;
+
+					for (int p = 0; p < PRODUCERS; p += 1) {
+						producers.push_back(std::thread([&, p](){
+							for (int i = 0; i < COUNT; i += 1) {
+								event_loop->post_notification(new NotificationSource([&, p, i](Loop *, NotificationSource *, Event){
+									// Notifications from the same thread are processed in the order they were posted:
+									if (last[p] != i - 1)
+										ordered = false;
+
+									last[p] = i;
+									notification_count += 1;
+
+									if (notification_count >= PRODUCERS * COUNT)
+										event_loop->stop();
+								}), true);
+							}
+						}));
+					}
+
+					event_loop->set_stop_when_idle(false);
+					event_loop->run_until_timeout(2.0);
+
+					for (auto & producer : producers)
+						producer.join();
+
+					examiner << "All notifications occurred";
+					examiner.expect(notification_count) == PRODUCERS * COUNT;
+
+					examiner << "Notifications were processed in order";
+					examiner.expect(ordered) == true;
+				}
+			},
+
+			{"it should post functions from a different thread",
+				[](UnitTest::Examiner & examiner) {
+					const int COUNT = 1000;
+
+					auto event_loop = ref(new Loop);
+
+					int small_count = 0, large_count = 0;
+
+					std::thread producer([&](){
+						std::array<int, 64> payload;
+						payload.fill(1);
+
+						for (int i = 0; i < COUNT; i += 1) {
+							// Small enough to be stored inline:
+							event_loop->post([&](Loop *){
+								small_count += 1;
+							});
+
+							// Too large to be stored inline:
+							event_loop->post_urgent([&, payload](Loop * loop){
+								large_count += payload[i % payload.size()];
+
+								if (large_count >= COUNT)
+									loop->stop();
+							});
+						}
+					});
+
+					event_loop->set_stop_when_idle(false);
+					event_loop->run_until_timeout(2.0);
+
+					producer.join();
+
+					examiner << "All functions were invoked";
+					examiner.expect(small_count) == COUNT;
+					examiner.expect(large_count) == COUNT;
+				}
+			},
+
+			{"it should destroy functions which were never invoked",
+				[](UnitTest::Examiner & examiner) {
+					auto counter = std::make_shared<int>(0);
+
+					{
+						auto event_loop = ref(new Loop);
+
+						std::thread producer([&](){
+							event_loop->post([counter](Loop *){
+								*counter += 1;
+							});
+						});
+
+						producer.join();
+					}
+
+					examiner << "Function was not invoked";
+					examiner.expect(*counter) == 0;
+
+					examiner << "Function was destroyed with the loop";
+					examiner.expect(counter.use_count()) == 1;
+				}
+			},
+
+			{"it should post a batch of notifications from a different thread",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 100;
+
+					auto event_loop = ref(new Loop);
+					event_loop->set_stop_when_idle(false);
+
+					std::vector<std::size_t> order;
+					std::vector<Ref<INotificationSource>> notifications;
+
+					for (std::size_t i = 0; i < COUNT; i += 1) {
+						notifications.push_back(new NotificationSource([&, i](Loop * loop, NotificationSource *, Event){
+							order.push_back(i);
+
+							if (order.size() == COUNT)
+								loop->stop();
+						}));
+					}
+
+					std::thread producer([&](){
+						event_loop->post_notifications(notifications.begin(), notifications.end(), true);
+					});
+
+					event_loop->run_until_timeout(2.0);
+
+					producer.join();
+
+					examiner << "All notifications were processed";
+					examiner.expect(order.size()) == COUNT;
+
+					bool ordered = true;
+
+					for (std::size_t i = 0; i < order.size(); i += 1)
+						ordered = ordered && order[i] == i;
+
+					examiner << "Notifications were processed in order";
+					examiner.expect(ordered) == true;
+				}
+			},
+
+			{"it should process notifications in order of priority and deadline",
+				[](UnitTest::Examiner & examiner) {
+					auto event_loop = ref(new Loop);
+
+					std::vector<int> order;
+
+					// The loop hasn't run yet, so the functions are queued rather than invoked directly:
+					event_loop->post([&](Loop *){order.push_back(5);}, LOW_PRIORITY);
+					event_loop->post([&](Loop *){order.push_back(4);});
+					event_loop->post([&](Loop *){order.push_back(3);}, NORMAL_PRIORITY, 2.0);
+					event_loop->post([&](Loop *){order.push_back(2);}, NORMAL_PRIORITY, 1.0);
+					event_loop->post([&](Loop *){order.push_back(1);}, HIGH_PRIORITY);
+
+					event_loop->run_once(false);
+
+					examiner << "Notifications were processed by priority, then earliest deadline first";
+					bool ordered = order == std::vector<int>({1, 2, 3, 4, 5});
+					examiner.expect(ordered) == true;
+
+					examiner << "No deadlines were missed";
+					examiner.expect(event_loop->metrics().notifications_late.value()) == 0;
+				}
+			},
+
+			{"it should not starve low priority notifications",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 500;
+
+					auto event_loop = ref(new Loop);
+					event_loop->set_time_budget(0.002);
+
+					std::size_t high_count = 0, high_count_before_low = 0;
+
+					for (std::size_t i = 0; i < COUNT; i += 1) {
+						event_loop->post([&](Loop *){
+							Core::sleep(0.0001);
+							high_count += 1;
+						}, HIGH_PRIORITY);
+					}
+
+					event_loop->post([&](Loop *){
+						high_count_before_low = high_count;
+					}, LOW_PRIORITY);
+
+					while (high_count < COUNT)
+						event_loop->run_once(false);
+
+					examiner << "Low priority notification was processed while high priority notifications were waiting";
+					examiner.expect(high_count_before_low) < COUNT;
+				}
+			},
 		};
 	}
 }
@@ -10,6 +10,15 @@
 #include <Dream/Events/Thread.hpp>
 #include <Dream/Core/Logger.hpp>
 
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#if defined(TARGET_OS_LINUX)
+	#include <sched.h>
+#endif
+
 namespace Dream
 {
 	namespace Events
@@ -41,6 +50,14 @@ namespace Dream
 			}
 		}
 		
+		/// Exposes the head of a RingQueue, so that a fetch which has released its cells but not yet published the head can be simulated.
+		class StaleRingQueue : public RingQueue<int> {
+		public:
+			StaleRingQueue (std::size_t capacity) : RingQueue<int>(capacity) {}
+
+			void set_head (std::size_t head) { _head.store(head); }
+		};
+
 		UnitTest::Suite ThreadTestSuite {
 			"Dream::Events::Thread",
 			
@@ -105,10 +122,417 @@ namespace Dream
 						}
 					}
 
+					// The timers add to the queue, so the threads must be stopped before it is released:
+					t1->stop();
+					t2->stop();
+					t3->stop();
+
 					examiner << "Total was not incremented correctly.";
 					examiner.expect(total) > 1000;
 				}
 			},
+
+			{"it can queue move-only items in a bounded ring",
+				[](UnitTest::Examiner & examiner) {
+					Ref<RingQueue<std::unique_ptr<int>>> queue = new RingQueue<std::unique_ptr<int>>(3);
+
+					examiner << "Capacity was rounded up to a power of two";
+					examiner.expect(queue->capacity()) == 4;
+
+					for (int i = 0; i < 4; i += 1)
+						examiner.expect(queue->try_add(std::unique_ptr<int>(new int(i)))) == true;
+
+					std::unique_ptr<int> extra(new int(4));
+
+					examiner << "Adding to a full queue fails without moving the item";
+					examiner.expect(queue->try_add(std::move(extra))) == false;
+					examiner.expect(extra != nullptr) == true;
+
+					std::unique_ptr<int> items[8];
+
+					examiner << "Items were fetched in order";
+					examiner.expect(queue->fetch(items, 8)) == 4;
+					examiner.expect(*items[0]) == 0;
+					examiner.expect(*items[3]) == 3;
+
+					std::vector<std::unique_ptr<int>> batch;
+
+					for (int i = 0; i < 6; i += 1)
+						batch.emplace_back(new int(i));
+
+					examiner << "A batch is added up to the capacity";
+					examiner.expect(queue->try_add(batch.begin(), batch.end())) == 4;
+					examiner.expect(batch[4] != nullptr) == true;
+
+					examiner << "A batch can be fetched partially";
+					examiner.expect(queue->fetch(items, 3)) == 3;
+					examiner.expect(*items[2]) == 2;
+					examiner.expect(queue->fetch(items, 3)) == 1;
+					examiner.expect(*items[0]) == 3;
+					examiner.expect(queue->fetch(items, 3)) == 0;
+				}
+			},
+
+			{"it can stream items from several threads through a bounded ring",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t PRODUCERS = 4, COUNT = 100000;
+
+					Ref<RingQueue<std::size_t>> queue = new RingQueue<std::size_t>(256);
+					std::vector<std::thread> producers;
+
+					for (std::size_t producer = 0; producer < PRODUCERS; producer += 1) {
+						producers.emplace_back([&, producer](){
+							for (std::size_t i = 0; i < COUNT; i += 1) {
+								// Each item identifies its producer and its sequence number:
+								while (!queue->try_add(i * PRODUCERS + producer))
+									std::this_thread::yield();
+							}
+						});
+					}
+
+					std::vector<std::size_t> next(PRODUCERS, 0);
+					std::size_t fetched = 0;
+					bool ordered = true;
+
+					std::size_t items[64];
+
+					while (fetched < PRODUCERS * COUNT) {
+						std::size_t count = queue->fetch(items, 64);
+
+						if (count == 0)
+							std::this_thread::yield();
+
+						for (std::size_t i = 0; i < count; i += 1) {
+							std::size_t producer = items[i] % PRODUCERS;
+
+							ordered = ordered && items[i] / PRODUCERS == next[producer];
+							next[producer] += 1;
+						}
+
+						fetched += count;
+					}
+
+					for (auto & producer : producers)
+						producer.join();
+
+					examiner << "Items from each producer were fetched in order";
+					examiner.expect(ordered) == true;
+				}
+			},
+
+			{"it doesn't add a batch over items which haven't been fetched",
+				[](UnitTest::Examiner & examiner) {
+					Ref<StaleRingQueue> queue = new StaleRingQueue(4);
+
+					int items[4] = {0, 1, 2, 3};
+
+					examiner.expect(queue->try_add(items, items + 4)) == 4;
+					examiner.expect(queue->fetch(items, 4)) == 4;
+
+					// The cells have been released, but the head hasn't been published yet:
+					queue->set_head(0);
+
+					examiner << "Single items can reuse released cells";
+					examiner.expect(queue->try_add(4)) == true;
+					examiner.expect(queue->try_add(5)) == true;
+
+					int batch[3] = {6, 7, 8};
+
+					examiner << "A batch isn't added while the tail is more than a ring beyond the head";
+					examiner.expect(queue->try_add(batch, batch + 3)) == 0;
+
+					queue->set_head(4);
+
+					examiner << "A batch is added once the head is published";
+					examiner.expect(queue->try_add(batch, batch + 3)) == 2;
+
+					examiner << "Items are fetched in order";
+					examiner.expect(queue->fetch(items, 4)) == 4;
+					examiner.expect(items[0]) == 4;
+					examiner.expect(items[3]) == 7;
+				}
+			},
+
+			{"it can interleave single and batched adds with fetches on a bounded ring",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 100000, BATCH = 5;
+
+					// A small ring, so that producers frequently reuse cells released by a fetch which hasn't published its head yet:
+					Ref<RingQueue<std::size_t>> queue = new RingQueue<std::size_t>(8);
+
+					// Items from the single producer are even, and items from the batch producer are odd:
+					std::thread single([&](){
+						for (std::size_t i = 0; i < COUNT; i += 1) {
+							while (!queue->try_add(i * 2))
+								std::this_thread::yield();
+						}
+					});
+
+					std::thread batched([&](){
+						std::size_t items[BATCH];
+
+						for (std::size_t i = 0; i < COUNT; i += BATCH) {
+							for (std::size_t j = 0; j < BATCH; j += 1)
+								items[j] = (i + j) * 2 + 1;
+
+							std::size_t * begin = items, * end = items + BATCH;
+
+							while (begin != end) {
+								std::size_t added = queue->try_add(begin, end);
+
+								if (added == 0)
+									std::this_thread::yield();
+
+								begin += added;
+							}
+						}
+					});
+
+					std::size_t next[2] = {0, 0}, fetched = 0;
+					bool ordered = true;
+
+					std::size_t items[3];
+
+					while (fetched < COUNT * 2) {
+						std::size_t count = queue->fetch(items, 3);
+
+						if (count == 0)
+							std::this_thread::yield();
+
+						for (std::size_t i = 0; i < count; i += 1) {
+							std::size_t producer = items[i] % 2;
+
+							ordered = ordered && items[i] / 2 == next[producer];
+							next[producer] += 1;
+						}
+
+						fetched += count;
+					}
+
+					single.join();
+					batched.join();
+
+					examiner << "Every item was fetched exactly once, in order";
+					examiner.expect(ordered) == true;
+					examiner.expect(next[0]) == COUNT;
+					examiner.expect(next[1]) == COUNT;
+				}
+			},
+
+			{"it destroys items which were never fetched from a bounded ring",
+				[](UnitTest::Examiner & examiner) {
+					auto item = std::make_shared<int>(0);
+
+					{
+						Ref<RingQueue<std::shared_ptr<int>, SINGLE_PRODUCER>> queue = new RingQueue<std::shared_ptr<int>, SINGLE_PRODUCER>(4);
+
+						queue->try_add(item);
+						queue->try_add(item);
+					}
+
+					examiner << "Items were destroyed with the queue";
+					examiner.expect(item.use_count()) == 1;
+				}
+			},
+
+			{"it can invoke functions on a remote loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					Loop * remote = nullptr, * local = nullptr;
+					int result = 0;
+
+					loop->post_urgent([&](Loop *){
+						thread->loop()->invoke([&](Loop * loop){
+							remote = Loop::current();
+							return 6 * 7;
+						}).then([&](Loop * loop, int value){
+							local = Loop::current();
+							result = value;
+
+							loop->stop();
+						});
+					});
+
+					loop->run_until_timeout(1.0);
+					thread->stop();
+
+					examiner << "Function was invoked on the remote loop";
+					examiner.expect(remote) == thread->loop().get();
+
+					examiner << "Continuation was invoked on the local loop";
+					examiner.expect(local) == loop.get();
+
+					examiner << "Result was returned";
+					examiner.expect(result) == 42;
+				}
+			},
+
+			{"it invokes functions on a remote loop without a continuation",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					std::atomic<bool> invoked(false);
+
+					// The future is discarded, so the function is sent when it is destroyed:
+					thread->loop()->invoke([&](Loop *){
+						invoked = true;
+						return 42;
+					});
+
+					for (int i = 0; i < 100 && !invoked; i += 1)
+						Core::sleep(0.01);
+
+					thread->stop();
+
+					examiner << "Function was invoked";
+					examiner.expect(invoked.load()) == true;
+				}
+			},
+
+			{"it invokes discarded functions after the future is destroyed on the target loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+
+					bool invoked = false, invoked_by_destructor = true, thrown = false;
+
+					// Posted before the loop runs, so that it is invoked on the loop thread:
+					loop->post_urgent([&](Loop * loop){
+						loop->invoke([&](Loop *){
+							invoked = true;
+
+							throw std::runtime_error("failed");
+						});
+
+						invoked_by_destructor = invoked;
+					});
+
+					for (int i = 0; i < 10 && !invoked; i += 1) {
+						try {
+							loop->run_once(false);
+						} catch (std::runtime_error & exception) {
+							thrown = true;
+						}
+					}
+
+					examiner << "Function wasn't invoked by the destructor";
+					examiner.expect(invoked_by_destructor) == false;
+
+					examiner << "Function was invoked by the loop";
+					examiner.expect(invoked) == true;
+
+					examiner << "Exception was thrown by the loop rather than the destructor";
+					examiner.expect(thrown) == true;
+				}
+			},
+
+			{"it delivers exceptions from invoked functions to the continuation",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_stop_when_idle(false);
+
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					std::string message;
+					bool continued = false;
+					int result = 0;
+
+					loop->post_urgent([&](Loop *){
+						thread->loop()->invoke([](Loop *) -> int {
+							throw std::runtime_error("failed");
+						}).then(loop, [&](Loop *, int){
+							continued = true;
+						}, [&](Loop *, std::exception_ptr error){
+							try {
+								std::rethrow_exception(error);
+							} catch (std::runtime_error & exception) {
+								message = exception.what();
+							}
+
+							// The remote loop is still running:
+							thread->loop()->invoke([](Loop *){
+								return 42;
+							}).then([&](Loop * loop, int value){
+								result = value;
+								loop->stop();
+							});
+						});
+					});
+
+					loop->run_until_timeout(1.0);
+					thread->stop();
+
+					examiner << "Exception was delivered";
+					examiner.expect(message) == "failed";
+					examiner.expect(continued) == false;
+
+					examiner << "Remote loop continued running";
+					examiner.expect(result) == 42;
+				}
+			},
+
+			{"it can busy poll for notifications",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Thread> thread = new Thread;
+					thread->loop()->set_busy_poll(0.01);
+					thread->start();
+
+					std::atomic<int> count(0);
+
+					for (int i = 0; i < 100; i += 1) {
+						thread->loop()->post_urgent([&](Loop *){
+							count += 1;
+						});
+
+						Core::sleep(0.001);
+					}
+
+					for (int i = 0; i < 100 && count < 100; i += 1)
+						Core::sleep(0.01);
+
+					thread->stop();
+
+					examiner << "All notifications were processed";
+					examiner.expect(count.load()) == 100;
+
+					examiner << "Notifications arrived while the loop was spinning";
+					examiner.expect(thread->loop()->metrics().spin_hits.value()) > 0;
+				}
+			},
+
+#if defined(TARGET_OS_LINUX)
+			{"it can pin the loop to a CPU",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Thread> thread = new Thread;
+					thread->set_affinity({0});
+					thread->start();
+
+					std::atomic<int> cpu(-1);
+
+					thread->loop()->post_urgent([&](Loop *){
+						cpu = sched_getcpu();
+					});
+
+					for (int i = 0; i < 100 && cpu == -1; i += 1)
+						Core::sleep(0.01);
+
+					thread->stop();
+
+					examiner << "Loop ran on the given CPU";
+					examiner.expect(cpu.load()) == 0;
+
+					examiner << "Pinning is visible in the loop's metrics";
+					examiner.expect(thread->loop()->metrics().affinity.cpus().size()) == 1;
+					examiner.expect(thread->loop()->metrics().affinity.contains(0)) == true;
+				}
+			},
+#endif
 		};
 	}
 }
@@ -8,8 +8,16 @@
 
 #include <UnitTest/UnitTest.hpp>
 
+#include <Dream/Events/Interpolator.hpp>
 #include <Dream/Events/Loop.hpp>
 #include <Dream/Events/Source.hpp>
+#include <Dream/Events/Timers.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
 
 namespace Dream
 {
@@ -56,7 +64,414 @@ namespace Dream
 					examiner << "Ticker callback called correctly within specified timeout";
 					examiner.expect(ticks) == 10;
 				}
-			}
+			},
+
+			{"a timer is scheduled and called correctly using a timing wheel",
+				[](UnitTest::Examiner & examiner) {
+					auto event_loop = ref(new Loop);
+					event_loop->set_timer_queue(TIMER_WHEEL);
+
+					int ticks = 0, ticks_when_stopped = -1;
+
+					event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+						ticks_when_stopped = ticks;
+						event_loop->stop();
+					}, 0.105));
+
+					// A strict timer catches up if the loop is late, so the order of the callbacks doesn't depend on timing:
+					event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+						ticks += 1;
+					}, 0.01, true, true));
+
+					event_loop->run_forever();
+
+					examiner << "Ticker callback called for every tick before the timer which stopped the loop";
+					examiner.expect(ticks_when_stopped) == 10;
+				}
+			},
+
+			{"overdue timers are called in order of their timeout",
+				[](UnitTest::Examiner & examiner) {
+					const TimerQueueType types[] = {TIMER_HEAP, TIMER_WHEEL, TIMER_HYBRID};
+					const TimeT timeouts[] = {0.100, 0.002, 0.150, 0.005};
+
+					for (auto type : types) {
+						auto event_loop = ref(new Loop);
+						event_loop->set_timer_queue(type);
+
+						std::vector<TimeT> called;
+
+						for (auto timeout : timeouts) {
+							event_loop->schedule_timer(new TimerSource([&called, timeout](Loop *, TimerSource *, Event){
+								called.push_back(timeout);
+							}, timeout));
+						}
+
+						// Block the loop so that all of the other timers are overdue:
+						event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+							std::this_thread::sleep_for(std::chrono::milliseconds(200));
+						}, 0.001));
+
+						// A strict repeating timer which is late should not starve the other timers:
+						int ticks = 0, ticks_when_called = -1;
+
+						event_loop->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){
+							ticks += 1;
+						}, 0.01, true, true));
+
+						event_loop->schedule_timer(new TimerSource([&](Loop * loop, TimerSource *, Event){
+							ticks_when_called = ticks;
+							loop->stop();
+						}, 0.155));
+
+						event_loop->run_forever();
+
+						bool ordered = called.size() == 4 && called[0] == 0.002 && called[1] == 0.005 && called[2] == 0.100 && called[3] == 0.150;
+
+						examiner << "Overdue timers were called in order of their timeout for queue type " << type;
+						examiner.expect(ordered) == true;
+
+						examiner << "The late repeating timer was called for each tick before the last timer";
+						examiner.expect(ticks_when_called) == 15;
+					}
+				}
+			},
+
+			{"timers are never popped before they are due",
+				[](UnitTest::Examiner & examiner) {
+					const TimerQueueType types[] = {TIMER_HEAP, TIMER_WHEEL, TIMER_HYBRID};
+
+					Ref<TimerSource> source = new TimerSource([](Loop *, TimerSource *, Event){}, 1.0);
+
+					for (auto type : types) {
+						TimerQueue timers(type, 0.001);
+
+						std::srand(type);
+
+						// Timeouts spread from sub-millisecond to several days, so that all wheels are used:
+						for (int i = 0; i < 10000; i += 1) {
+							TimeT timeout = std::pow(10.0, (std::rand() % 1000) / 150.0 - 4.0);
+							timers.insert(timeout, source, 0);
+						}
+
+						std::size_t popped = 0, early = 0;
+						TimeT current_time = 0, lateness = 0;
+
+						while (!timers.empty()) {
+							TimeT next;
+							timers.next_timeout(next);
+
+							// Step forward irregularly, but never beyond the next timeout:
+							current_time = std::max(current_time, next) + (std::rand() % 3) * 0.0003;
+
+							TimerHandle handle;
+							TimeT timeout;
+							Ref<ITimerSource> popped_source;
+
+							while (timers.pop(current_time, handle, timeout, popped_source)) {
+								timers.remove(handle);
+								popped += 1;
+
+								if (timeout > current_time)
+									early += 1;
+
+								lateness = std::max(lateness, current_time - timeout);
+							}
+						}
+
+						examiner << "All timers were popped";
+						examiner.expect(popped) == 10000;
+
+						examiner << "No timer was popped before it was due";
+						examiner.expect(early) == 0;
+
+						examiner << "Timers were popped within the resolution of the wheel";
+						examiner.expect(lateness) < 0.002;
+					}
+				}
+			},
+
+			{"Cancelled timers leave the loop immediately",
+				[](UnitTest::Examiner & examiner) {
+					const TimerQueueType types[] = {TIMER_HEAP, TIMER_WHEEL};
+
+					for (auto type : types) {
+						Ref<Loop> events = new Loop;
+						events->set_stop_when_idle(true);
+						events->set_timer_queue(type);
+
+						int fired = 0;
+						Ref<TimerSource> source = new TimerSource([&](Loop *, TimerSource *, Event){ fired += 1; }, 10.0);
+
+						// The results of cancelling a timer are only returned on the thread which runs the loop:
+						events->run_once(false);
+
+						TimerHandle handle = events->schedule_timer(source);
+
+						examiner << "Timer was cancelled";
+						examiner.expect(events->cancel_timer(handle)) == true;
+
+						examiner << "Handle is no longer valid";
+						examiner.expect(events->cancel_timer(handle)) == false;
+
+						Stopwatch stopwatch;
+						stopwatch.start();
+						events->run_forever();
+
+						examiner << "Loop stopped without waiting for the cancelled timer";
+						examiner.expect(stopwatch.time()) < 1.0;
+						examiner.expect(fired) == 0;
+					}
+				}
+			},
+
+			{"Cancelling a timer source removes it from the loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+
+					events->run_once(false);
+
+					int fired = 0;
+					Ref<TimerSource> source = new TimerSource([&](Loop *, TimerSource *, Event){ fired += 1; }, 10.0);
+					Ref<Interpolator> interpolator = new Interpolator(10, 10.0);
+
+					events->schedule_timer(source);
+					events->schedule_timer(interpolator);
+
+					source->cancel();
+					interpolator->cancel();
+
+					Stopwatch stopwatch;
+					stopwatch.start();
+					events->run_forever();
+
+					examiner << "Loop stopped without waiting for the cancelled timers";
+					examiner.expect(stopwatch.time()) < 1.0;
+					examiner.expect(fired) == 0;
+				}
+			},
+
+			{"Cancelling a timer source from a different thread removes it from the loop",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+
+					std::atomic<int> fired(0);
+					Ref<TimerSource> source = new TimerSource([&](Loop *, TimerSource *, Event){ fired += 1; }, 0.01, true);
+
+					events->schedule_timer(source);
+
+					std::atomic<bool> stopped(false);
+
+					std::thread runner([&](){
+						events->run_forever();
+						stopped = true;
+					});
+
+					// Wait until the timer is running on the loop thread:
+					for (std::size_t i = 0; i < 100 && fired == 0; i += 1)
+						Core::sleep(0.01);
+
+					source->cancel();
+					int fired_when_cancelled = fired;
+
+					for (std::size_t i = 0; i < 100 && !stopped; i += 1)
+						Core::sleep(0.01);
+
+					examiner << "Loop stopped once the cancelled timer was removed";
+					examiner.expect(stopped.load()) == true;
+
+					if (!stopped)
+						events->stop();
+
+					runner.join();
+
+					examiner << "Timer fired before it was cancelled, and at most once more";
+					examiner.expect(fired_when_cancelled) > 0;
+					examiner.expect(fired.load()) <= fired_when_cancelled + 1;
+				}
+			},
+
+			{"Timers scheduled from a different thread can be cancelled and rescheduled",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+
+					Stopwatch stopwatch;
+					int fired = 0;
+					TimeT fired_at = 0;
+					TimerHandle cancelled, rescheduled;
+
+					std::thread producer([&](){
+						cancelled = events->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){ fired += 1; }, 0.05));
+						events->cancel_timer(cancelled);
+
+						rescheduled = events->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){ fired_at = stopwatch.time(); }, 10.0));
+						events->reschedule_timer(rescheduled, 0.05);
+					});
+
+					producer.join();
+
+					stopwatch.start();
+					events->run_forever();
+
+					examiner << "Handles were returned";
+					examiner.expect(bool(cancelled)) == true;
+					examiner.expect(bool(rescheduled)) == true;
+
+					examiner << "Cancelled timer didn't fire";
+					examiner.expect(fired) == 0;
+
+					examiner << "Rescheduled timer fired at its new timeout";
+					examiner.expect(fired_at) > 0.04;
+					examiner.expect(fired_at) < 1.0;
+				}
+			},
+
+			{"Timers scheduled from a different thread can be cancelled before they are added",
+				[](UnitTest::Examiner & examiner) {
+					Ref<TimerSource> source = new TimerSource([](Loop *, TimerSource *, Event){}, 1.0);
+
+					TimerQueue timers;
+					TimerHandle handle = timers.reserve();
+
+					examiner << "Reserved handle can be removed before it is added";
+					examiner.expect(timers.valid(handle)) == false;
+					examiner.expect(timers.remove(handle)) == true;
+
+					examiner << "Removed handle isn't added";
+					examiner.expect(timers.insert(handle, 1.0, source, 0)) == false;
+					examiner.expect(timers.empty()) == true;
+					examiner.expect(timers.remove(handle)) == false;
+
+					TimerHandle next = timers.insert(1.0, source, 0);
+
+					examiner << "Entry was reused with a new generation";
+					examiner.expect(next.index) == handle.index;
+					examiner.expect(next.generation != handle.generation) == true;
+
+					// The same, using a loop:
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+
+					events->run_once(false);
+
+					int fired = 0;
+
+					std::thread producer([&](){
+						handle = events->schedule_timer(new TimerSource([&](Loop *, TimerSource *, Event){ fired += 1; }, 0.05));
+					});
+
+					producer.join();
+
+					examiner << "Timer was cancelled on the loop thread";
+					examiner.expect(events->cancel_timer(handle)) == true;
+
+					events->run_until_timeout(0.5);
+
+					examiner.expect(fired) == 0;
+				}
+			},
+
+			{"Timers can be rescheduled",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+
+					Stopwatch stopwatch;
+					TimeT fired_at = 0;
+					TimerHandle handle;
+
+					Ref<TimerSource> source = new TimerSource([&](Loop *, TimerSource *, Event){ fired_at = stopwatch.time(); }, 0.1);
+
+					events->run_once(false);
+
+					// Pushed back twice, as an idle timeout would be:
+					events->schedule_timer(new TimerSource([&](Loop * loop, TimerSource *, Event){ loop->reschedule_timer(handle, 0.2); }, 0.05));
+					events->schedule_timer(new TimerSource([&](Loop * loop, TimerSource *, Event){ loop->reschedule_timer(handle, 0.2); }, 0.15));
+
+					stopwatch.start();
+					handle = events->schedule_timer(source);
+					events->run_forever();
+
+					examiner << "Timer fired after it was rescheduled";
+					examiner.expect(fired_at) > 0.34;
+					examiner.expect(fired_at) < 0.45;
+
+					examiner << "Handle is invalid after a non-repeating timer fired";
+					examiner.expect(events->reschedule_timer(handle, 1.0)) == false;
+				}
+			},
+
+			{"Timers within the slack are processed together",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(true);
+					events->set_timer_slack(0.05);
+
+					const TimeT start = events->stopwatch().time();
+					TimeT first = 1e9, last = 0;
+					std::size_t early = 0;
+
+					for (std::size_t i = 0; i < 40; i += 1) {
+						TimeT duration = 0.01 + i * 0.001;
+
+						events->schedule_timer(new TimerSource([&, duration](Loop * loop, TimerSource *, Event){
+							TimeT elapsed = loop->stopwatch().time() - start;
+
+							if (elapsed < duration)
+								early += 1;
+
+							first = std::min(first, elapsed);
+							last = std::max(last, elapsed);
+						}, duration));
+					}
+
+					events->run_forever();
+
+					examiner << "No timer fired early";
+					examiner.expect(early) == 0;
+
+					examiner << "All timers fired in one batch";
+					examiner.expect(last - first) < 0.005;
+				}
+			},
+
+			{"Timers can be scheduled in a batch from a different thread",
+				[](UnitTest::Examiner & examiner) {
+					const std::size_t COUNT = 10;
+
+					Ref<Loop> events = new Loop;
+					events->set_stop_when_idle(false);
+
+					std::size_t fired = 0;
+					std::vector<Ref<TimerSource>> timers;
+
+					for (std::size_t i = 0; i < COUNT; i += 1) {
+						timers.push_back(new TimerSource([&](Loop * loop, TimerSource *, Event){
+							fired += 1;
+
+							if (fired == COUNT)
+								loop->stop();
+						}, 0.01 + i * 0.001));
+					}
+
+					std::thread producer([&](){
+						events->schedule_timers(timers.begin(), timers.end());
+					});
+
+					producer.join();
+
+					events->run_until_timeout(1.0);
+
+					examiner << "All timers fired";
+					examiner.expect(fired) == COUNT;
+
+					examiner << "Timers were sent in a single notification";
+					examiner.expect(events->metrics().notification_depth.total()) == 1;
+				}
+			},
 		};
 	}
 }
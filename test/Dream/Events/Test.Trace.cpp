@@ -0,0 +1,158 @@
+//
+//  Test.Trace.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Loop.hpp>
+#include <Dream/Events/Trace.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+namespace Dream
+{
+	namespace Events
+	{
+		UnitTest::Suite TraceTestSuite {
+			"Dream::Events::Trace",
+
+			{"it should record loop activity as Chrome trace events",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Loop> loop = new Loop;
+					loop->set_trace(new Trace);
+					loop->run_once(false);
+
+					// The timer is due after the producer has posted, so that the loop blocks waiting for it:
+					loop->schedule_timer(new TimerSource([](Loop *, TimerSource *, Event) {}, 0.05));
+
+					std::thread producer([&](){
+						loop->post_notification(new NotificationSource([](Loop *, NotificationSource *, Event) {}), true);
+					});
+
+					producer.join();
+
+					loop->run_until_timeout(0.1);
+
+					std::stringstream output;
+					loop->trace()->write(output);
+
+					std::string json = output.str();
+
+					examiner << "Phases of the loop were recorded";
+					examiner.expect(json.find("\"name\":\"process_timers\"") != std::string::npos) == true;
+					examiner.expect(json.find("\"name\":\"blocked\"") != std::string::npos) == true;
+
+					examiner << "Sources were recorded by type";
+					examiner.expect(json.find("TimerSource") != std::string::npos) == true;
+					examiner.expect(json.find("NotificationSource") != std::string::npos) == true;
+
+					examiner << "Posting across threads was recorded as a flow";
+					examiner.expect(json.find("\"ph\":\"s\"") != std::string::npos) == true;
+					examiner.expect(json.find("\"ph\":\"f\"") != std::string::npos) == true;
+				}
+			},
+
+			{"it should keep the most recent events",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Trace> trace = new Trace(4);
+
+					trace->begin("first");
+					trace->end();
+
+					for (std::size_t i = 0; i < 2; i += 1) {
+						trace->begin("second");
+						trace->end();
+					}
+
+					std::stringstream output;
+					trace->write(output);
+
+					examiner << "All events were counted";
+					examiner.expect(trace->size()) == 6;
+
+					examiner << "The oldest events were overwritten";
+					examiner.expect(output.str().find("first") == std::string::npos) == true;
+					examiner.expect(output.str().find("second") != std::string::npos) == true;
+				}
+			},
+
+			{"it should write valid JSON without changing the formatting of the stream",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Trace> trace = new Trace;
+
+					trace->begin("a \"quoted\" name");
+					trace->end();
+
+					std::stringstream output;
+					std::ios_base::fmtflags flags = output.flags();
+					std::streamsize precision = output.precision();
+
+					trace->write(output);
+
+					examiner << "Quotes in names were escaped";
+					examiner.expect(output.str().find("\"name\":\"a \\\"quoted\\\" name\"") != std::string::npos) == true;
+
+					examiner << "The formatting of the stream was restored";
+					examiner.expect(output.flags() == flags) == true;
+					examiner.expect(output.precision()) == precision;
+				}
+			},
+
+			{"it should only write complete events while they are being recorded",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Trace> trace = new Trace(64);
+					std::atomic<bool> finished(false);
+
+					// Each event has the same timestamp and duration, so a partially overwritten event can be detected:
+					std::thread recorder([&](){
+						for (std::uint64_t i = 1; !finished; i += 1)
+							trace->complete("event", i * 1000, i * 1000);
+					});
+
+					// Wait until the buffer is being overwritten:
+					while (trace->size() < 64)
+						std::this_thread::yield();
+
+					std::size_t events = 0, torn = 0;
+
+					for (std::size_t i = 0; i < 100; i += 1) {
+						std::stringstream output;
+						trace->write(output);
+
+						std::string line;
+
+						while (std::getline(output, line)) {
+							std::size_t ts = line.find("\"ts\":"), dur = line.find(",\"dur\":");
+
+							if (ts == std::string::npos || dur == std::string::npos)
+								continue;
+
+							std::string timestamp = line.substr(ts + 5, dur - ts - 5);
+							std::string duration = line.substr(dur + 7, line.find(',', dur + 1) - dur - 7);
+
+							events += 1;
+
+							if (timestamp != duration || line.find("\"name\":\"event\"") == std::string::npos)
+								torn += 1;
+						}
+					}
+
+					finished = true;
+					recorder.join();
+
+					examiner << "Events were written while being recorded";
+					examiner.expect(events) > 0;
+
+					examiner << "No partially overwritten events were written";
+					examiner.expect(torn) == 0;
+				}
+			},
+		};
+	}
+}
@@ -0,0 +1,124 @@
+//
+//  Test.Watchdog.cpp
+//  This file is part of the "Dream" project and released under the MIT License.
+//
+//  Created by Samuel Williams on 16/10/2026.
+//  Copyright, 2026, by Samuel Williams. All rights reserved.
+//
+
+#include <UnitTest/UnitTest.hpp>
+
+#include <Dream/Events/Thread.hpp>
+#include <Dream/Events/Watchdog.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace Dream
+{
+	namespace Events
+	{
+		class BlockingSource : public Object, virtual public INotificationSource {
+		public:
+			virtual void process_events (Loop *, Event)
+			{
+				Core::sleep(0.2);
+			}
+		};
+
+		UnitTest::Suite WatchdogTestSuite {
+			"Dream::Events::Watchdog",
+
+			{"it should report a blocked source without interrupting it",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					std::mutex lock;
+					std::vector<Stall> stalls;
+
+					Ref<Watchdog> watchdog = new Watchdog(0.05, [&](const Stall & stall) {
+						std::lock_guard<std::mutex> guard(lock);
+						stalls.push_back(stall);
+					});
+
+					watchdog->watch(thread->loop());
+					watchdog->start();
+
+					// An idle loop is waiting, so it shouldn't be reported:
+					Core::sleep(0.1);
+
+					std::atomic<bool> finished(false);
+
+					thread->loop()->post_notification(new BlockingSource, true);
+					thread->loop()->post_urgent([&](Loop *){
+						finished = true;
+					});
+
+					for (std::size_t i = 0; i < 100 && !finished; i += 1)
+						Core::sleep(0.01);
+
+					watchdog->stop();
+					thread->stop();
+
+					examiner << "The blocked loop was reported once";
+					examiner.expect(stalls.size()) == 1;
+
+					if (stalls.size() == 1) {
+						examiner << "The blocking source was identified";
+						examiner.expect(stalls[0].source) == "Dream::Events::BlockingSource";
+						examiner.expect(stalls[0].duration) >= 0.05;
+
+						examiner << "Backtraces are only captured if enabled";
+						examiner.expect(stalls[0].backtrace.empty()) == true;
+					}
+
+					examiner << "The loop continued after the stall";
+					examiner.expect(finished.load()) == true;
+				}
+			},
+
+#if defined(TARGET_OS_LINUX) && defined(__GLIBC__)
+			{"it should capture the stack of a blocked loop if enabled",
+				[](UnitTest::Examiner & examiner) {
+					Ref<Thread> thread = new Thread;
+					thread->start();
+
+					std::mutex lock;
+					std::vector<Stall> stalls;
+
+					Ref<Watchdog> watchdog = new Watchdog(0.05, [&](const Stall & stall) {
+						std::lock_guard<std::mutex> guard(lock);
+						stalls.push_back(stall);
+					});
+
+					watchdog->set_backtrace(true);
+					watchdog->watch(thread->loop());
+					watchdog->start();
+
+					std::atomic<bool> finished(false);
+
+					thread->loop()->post_notification(new BlockingSource, true);
+					thread->loop()->post_urgent([&](Loop *){
+						finished = true;
+					});
+
+					for (std::size_t i = 0; i < 100 && !finished; i += 1)
+						Core::sleep(0.01);
+
+					watchdog->stop();
+					thread->stop();
+
+					examiner << "The blocked loop was reported";
+					examiner.expect(stalls.size()) == 1;
+
+					if (stalls.size() == 1) {
+						examiner << "The stack of the loop thread was captured";
+						examiner.expect(stalls[0].backtrace.empty()) == false;
+					}
+				}
+			},
+#endif
+		};
+	}
+}